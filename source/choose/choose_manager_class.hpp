@@ -17,9 +17,12 @@ Calls the client-specified callback routine if a different object is chosen.
 #if !defined (CHOOSE_MANAGER_CLASS_H)
 #define CHOOSE_MANAGER_CLASS_H
 
+#include <cstring>
 #include "choose/choose_class.hpp"
 #include "general/mystring.h"
 #include "general/message.h"
+#include "user_interface/event_dispatcher.h"
+#include "user_interface/user_interface.h"
 
 template < class Managed_object, class Manager > class Managed_object_chooser
 /*****************************************************************************
@@ -36,7 +39,10 @@ private:
 	void *manager_callback_id;
 	wxChooser<Managed_object*> *chooser;
 	Callback_base<Managed_object *> *update_callback;
-   int number_of_items;
+	User_interface *user_interface;
+	/* pending idle callback for coalescing menu updates, if any */
+	struct Event_dispatcher_idle_callback *idle_update_callback_id;
+   int number_of_items, allocated_number_of_items;
    Managed_object **items;
    char **item_names;
    bool null_item_flag;
@@ -44,6 +50,8 @@ private:
 	static void global_object_change(typename Manager::Manager_message_type *message,
 		void *class_chooser_void);
 
+	static int idle_update_callback(void *class_chooser_void);
+
 public:
 	Managed_object_chooser(wxPanel *parent,
 		Managed_object *current_object,
@@ -53,7 +61,8 @@ public:
 		User_interface *user_interface) :
 		manager(new Manager(struct_manager)), parent(parent),
 		conditional_function(conditional_function),
-		conditional_function_user_data(conditional_function_user_data)
+		conditional_function_user_data(conditional_function_user_data),
+		user_interface(user_interface)
 /*****************************************************************************
 LAST MODIFIED : 8 February 2007
 
@@ -63,7 +72,9 @@ DESCRIPTION :
 		manager_callback_id = (void *)NULL;
 		chooser = (wxChooser<Managed_object*> *)NULL;
 		update_callback = (Callback_base<Managed_object*> *)NULL;
+		idle_update_callback_id = (struct Event_dispatcher_idle_callback *)NULL;
 		number_of_items = 0;
+		allocated_number_of_items = 0;
 		items = (Managed_object **)NULL;
 		item_names = (char **)NULL;
 		null_item_flag = false;
@@ -102,6 +113,7 @@ DESCRIPTION :
 	{
 		int i;
 
+		cancel_idle_update();
 		if (number_of_items>=0)
 		{
 			 if (items)
@@ -139,6 +151,12 @@ Called by the
 	{
 		int return_code;
 
+		if (idle_update_callback_id)
+		{
+			/* menu may be out of date: bring it up to date and use the object
+				actually chosen in it */
+			object = get_object();
+		}
 		if (update_callback)
 		{
 			/* now call the procedure with the user data */
@@ -160,6 +178,7 @@ Called by the
 		if (null_item_flag != flag)
 		{
 			null_item_flag = flag;
+			cancel_idle_update();
 			if (build_items())
 			{
 				return_code=chooser->build_main_menu(
@@ -184,6 +203,7 @@ Called by the
 			if (manager && manager_callback_id)
 				manager->deregister_callback(manager_callback_id);
 			manager = temp_manager;
+			cancel_idle_update();
 			if (build_items())
 			{
 				return_code=chooser->build_main_menu(
@@ -240,6 +260,7 @@ DESCRIPTION :
 Returns the currently chosen object.
 ============================================================================*/
 	{
+		flush_idle_update();
 		return(chooser->get_item());
 	} /* Managed_object_chooser::get_object */
 
@@ -251,6 +272,7 @@ DESCRIPTION :
 Returns the number in list
 ============================================================================*/
 	{
+		flush_idle_update();
 		return(chooser->get_number_of_item());
 	} /* Managed_object_chooser::get_object */
 
@@ -263,6 +285,7 @@ DESCRIPTION :
 Changes the chosen object in the choose_object_widget.
 ============================================================================*/
 	{
+		flush_idle_update();
 		return(chooser->set_item(new_object));
 	} /* Managed_object_chooser::set_object */
 
@@ -281,6 +304,7 @@ selection of objects. Also allows new_object to be set simultaneously.
 
 		conditional_function = in_conditional_function;
 		conditional_function_user_data = in_conditional_function_user_data;
+		cancel_idle_update();
 		if (build_items())
 		{
 			return_code=chooser->build_main_menu(
@@ -308,18 +332,11 @@ LAST MODIFIED : 8 February 2007
 DESCRIPTION :
 ============================================================================*/
 	{
-		int i, return_code;
+		int return_code;
 
 		if (object)
 		{
-			return_code = 0;
-			for (i = 0 ; !return_code && (i < number_of_items) ; i++)
-			{
-				if (object == items[i])
-				{
-					return_code=1;
-				}
-			}
+			return_code = (0 <= find_item_index(object));
 		}
 		else
 		{
@@ -331,6 +348,241 @@ DESCRIPTION :
 		return (return_code);
 	} /* Managed_object_chooser::is_item_in_chooser */
 
+	/** Index of first object item, after the null item if any */
+	int first_object_index() const
+	{
+		return null_item_flag ? 1 : 0;
+	}
+
+	/**
+	 * Binary search of the object items, which are kept in name order, for name.
+	 * @return  Index of first item with name not less than name.
+	 */
+	int lower_bound_item_index(const char *name) const
+	{
+		int low = first_object_index();
+		int high = number_of_items;
+		while (low < high)
+		{
+			const int mid = (low + high) / 2;
+			if (strcmp(item_names[mid], name) < 0)
+				low = mid + 1;
+			else
+				high = mid;
+		}
+		return low;
+	}
+
+	/**
+	 * Find index of object in items. Tries a binary search by the object's
+	 * current name first, falling back to a linear search for renamed objects.
+	 * @return  Index or -1 if not in chooser.
+	 */
+	int find_item_index(Managed_object *object)
+	{
+		char *name = 0;
+		if (manager->get_object_name(object, &name) && name)
+		{
+			int i = lower_bound_item_index(name);
+			DEALLOCATE(name);
+			if ((i < number_of_items) && (items[i] == object))
+				return i;
+		}
+		for (int i = first_object_index(); i < number_of_items; i++)
+		{
+			if (items[i] == object)
+				return i;
+		}
+		return -1;
+	}
+
+	/** Inserts object in items at its sorted position by name. */
+	int insert_item(Managed_object *object)
+	{
+		char *name = 0;
+		if (!(manager->get_object_name(object, &name) && name))
+		{
+			display_message(ERROR_MESSAGE,
+				"Managed_object_chooser::insert_item.  Could not get name of object");
+			return 0;
+		}
+		if (number_of_items >= allocated_number_of_items)
+		{
+			const int new_allocated_number_of_items = 2*allocated_number_of_items + 8;
+			Managed_object **new_items;
+			char **new_item_names;
+			if (REALLOCATE(new_items, items, Managed_object *, new_allocated_number_of_items))
+			{
+				items = new_items;
+				if (REALLOCATE(new_item_names, item_names, char *, new_allocated_number_of_items))
+				{
+					item_names = new_item_names;
+					allocated_number_of_items = new_allocated_number_of_items;
+				}
+			}
+			if (number_of_items >= allocated_number_of_items)
+			{
+				display_message(ERROR_MESSAGE,
+					"Managed_object_chooser::insert_item.  Could not enlarge items");
+				DEALLOCATE(name);
+				return 0;
+			}
+		}
+		const int index = lower_bound_item_index(name);
+		const int number_to_move = number_of_items - index;
+		if (number_to_move > 0)
+		{
+			memmove(items + index + 1, items + index, number_to_move*sizeof(Managed_object *));
+			memmove(item_names + index + 1, item_names + index, number_to_move*sizeof(char *));
+		}
+		items[index] = object;
+		item_names[index] = name;
+		number_of_items++;
+		return 1;
+	}
+
+	/** Removes item at index from items. */
+	void remove_item(int index)
+	{
+		DEALLOCATE(item_names[index]);
+		const int number_to_move = number_of_items - index - 1;
+		if (number_to_move > 0)
+		{
+			memmove(items + index, items + index + 1, number_to_move*sizeof(Managed_object *));
+			memmove(item_names + index, item_names + index + 1, number_to_move*sizeof(char *));
+		}
+		number_of_items--;
+	}
+
+	/** Manager message iterator counting changed objects. Always returns 0 to
+	 * visit all changed objects. */
+	static int count_changed_object(Managed_object *object, void *count_void)
+	{
+		USE_PARAMETER(object);
+		++(*(static_cast<int *>(count_void)));
+		return 0;
+	}
+
+	/** Manager message iterator removing each removed object from the items.
+	 * Always returns 0 to visit all changed objects. */
+	static int remove_changed_object(Managed_object *object, void *class_chooser_void)
+	{
+		Managed_object_chooser *class_chooser =
+			static_cast<Managed_object_chooser *>(class_chooser_void);
+		const int index = class_chooser->find_item_index(object);
+		if (0 <= index)
+			class_chooser->remove_item(index);
+		return 0;
+	}
+
+	/** Manager message iterator putting each changed object at its sorted
+	 * position in items if it passes the conditional function, otherwise
+	 * removing it. Always returns 0 to visit all changed objects. */
+	static int update_changed_object(Managed_object *object, void *class_chooser_void)
+	{
+		Managed_object_chooser *class_chooser =
+			static_cast<Managed_object_chooser *>(class_chooser_void);
+		const int index = class_chooser->find_item_index(object);
+		if (0 <= index)
+			class_chooser->remove_item(index);
+		if (!(class_chooser->conditional_function) ||
+			(class_chooser->conditional_function)(object,
+				class_chooser->conditional_function_user_data))
+		{
+			class_chooser->insert_item(object);
+		}
+		return 0;
+	}
+
+	/** Manager message iterator adding each added object to items if it passes
+	 * the conditional function and is not already there. Always returns 0 to
+	 * visit all changed objects. */
+	static int add_changed_object(Managed_object *object, void *class_chooser_void)
+	{
+		Managed_object_chooser *class_chooser =
+			static_cast<Managed_object_chooser *>(class_chooser_void);
+		if ((class_chooser->find_item_index(object) < 0) &&
+			(!(class_chooser->conditional_function) ||
+				(class_chooser->conditional_function)(object,
+					class_chooser->conditional_function_user_data)))
+		{
+			class_chooser->insert_item(object);
+		}
+		return 0;
+	}
+
+	/**
+	 * Applies the add, remove and rename changes in the manager message to the
+	 * sorted items, or rebuilds them if most objects have changed.
+	 */
+	int update_items(typename Manager::Manager_message_type *message)
+	{
+		int number_of_changed_objects = 0;
+		manager->manager_message_has_changed_object_that(message,
+			Manager::Manager_change_add | Manager::Manager_change_remove | Manager::Manager_change_identifier,
+			count_changed_object, &number_of_changed_objects);
+		if (number_of_changed_objects > (number_of_items / 4 + 16))
+			return build_items();
+		manager->manager_message_has_changed_object_that(message,
+			Manager::Manager_change_remove, remove_changed_object, this);
+		manager->manager_message_has_changed_object_that(message,
+			Manager::Manager_change_identifier, update_changed_object, this);
+		manager->manager_message_has_changed_object_that(message,
+			Manager::Manager_change_add, add_changed_object, this);
+		if (conditional_function)
+		{
+			manager->manager_message_has_changed_object_that(message,
+				Manager::Manager_change_object_not_identifier, update_changed_object, this);
+		}
+		return 1;
+	}
+
+	/** Rebuilds the menu from the items, keeping the current object. */
+	int update_menu()
+	{
+		return chooser->build_main_menu(
+			number_of_items, items, item_names, chooser->get_item());
+	}
+
+	/** Schedules a single menu update for the end of the current event loop
+	 * iteration, or updates immediately if there is no user interface. */
+	int update_menu_in_idle_time()
+	{
+		if (idle_update_callback_id)
+			return 1;
+		if (user_interface)
+		{
+			idle_update_callback_id = Event_dispatcher_add_idle_callback(
+				User_interface_get_event_dispatcher(user_interface),
+				idle_update_callback, (void *)this,
+				EVENT_DISPATCHER_TRACKING_EDITOR_PRIORITY);
+			if (idle_update_callback_id)
+				return 1;
+		}
+		return update_menu();
+	}
+
+	void cancel_idle_update()
+	{
+		if (idle_update_callback_id)
+		{
+			Event_dispatcher_remove_idle_callback(
+				User_interface_get_event_dispatcher(user_interface),
+				idle_update_callback_id);
+			idle_update_callback_id = (struct Event_dispatcher_idle_callback *)NULL;
+		}
+	}
+
+	/** Performs any pending menu update now, so the menu matches the items. */
+	void flush_idle_update()
+	{
+		if (idle_update_callback_id)
+		{
+			cancel_idle_update();
+			update_menu();
+		}
+	}
+
 	/** A manager iterator which adds each object to the chooser */
 	static int add_object_to_list(Managed_object *object, void *chooser_object_void)
 	{
@@ -388,6 +640,7 @@ DESCRIPTION :
 			item_names = 0;
 		}
 		number_of_items = 0;
+		allocated_number_of_items = 0;
 		int return_code = 1;
 		if (manager && manager->manager)
 		{
@@ -404,6 +657,7 @@ DESCRIPTION :
 			{
 				items = new_items;
 				item_names = new_item_names;
+				allocated_number_of_items = max_number_of_objects;
 				if (null_item_flag)
 				{
 					*(this->item_names) = duplicate_string("-");
@@ -471,9 +725,11 @@ template  < class Managed_object, class Manager > void Managed_object_chooser<Ma
 LAST MODIFIED : 7 February 2007
 
 DESCRIPTION :
-Rebuilds the choose object menu in response to manager messages.
+Updates the choose object menu in response to manager messages.
 Tries to minimise menu rebuilds as much as possible, since these cause
-annoying flickering on the screen.
+annoying flickering on the screen: add, remove and rename changes are applied
+to the sorted items directly, and the menu is rebuilt once in idle time
+however many messages arrive before then.
 ============================================================================*/
 {
 	Managed_object_chooser* class_chooser;
@@ -508,10 +764,8 @@ annoying flickering on the screen.
 		}
 		if (update_menu)
 		{
-		  if (!(class_chooser->build_items() &&
-				class_chooser->chooser->build_main_menu(
-					class_chooser->number_of_items, class_chooser->items, class_chooser->item_names,
-					class_chooser->chooser->get_item())))
+			if (!(class_chooser->update_items(message) &&
+				class_chooser->update_menu_in_idle_time()))
 			{
 				display_message(ERROR_MESSAGE,
 					"Managed_object_chooser::global_object_change.  "
@@ -528,5 +782,29 @@ annoying flickering on the screen.
 	LEAVE;
 } /* Managed_object_chooser::global_object_change */
 
+template  < class Managed_object, class Manager > int Managed_object_chooser<Managed_object,Manager> ::idle_update_callback(
+	void *class_chooser_void)
+/*****************************************************************************
+DESCRIPTION :
+Rebuilds the menu once for all manager changes since the last update.
+============================================================================*/
+{
+	Managed_object_chooser* class_chooser =
+		static_cast<Managed_object_chooser *>(class_chooser_void);
+	if (class_chooser)
+	{
+		/* set idle callback no longer pending */
+		class_chooser->idle_update_callback_id = (struct Event_dispatcher_idle_callback *)NULL;
+		if (!class_chooser->update_menu())
+		{
+			display_message(ERROR_MESSAGE,
+				"Managed_object_chooser::idle_update_callback.  "
+				"Could not update menu");
+		}
+	}
+	/* We don't want the idle callback to repeat so we return 0 */
+	return 0;
+}
+
 
 #endif /* !defined (CHOOSE_MANAGER_CLASS_H) */
@@ -27,6 +27,7 @@ SET(APP_HDRS
     source/image_processing/computed_field_curvature_anisotropic_diffusion_image_filter_app.h
     source/image_processing/computed_field_histogram_image_filter_app.h
     source/image_processing/computed_field_discrete_gaussian_image_filter_app.h
+    source/image_processing/image_filter_app.h
     source/image_processing/computed_field_connected_threshold_image_filter_app.h
     source/image_processing/computed_field_gradient_magnitude_recursive_gaussian_image_filter_app.h
     source/image_processing/computed_field_fast_marching_image_filter_app.h
@@ -59,6 +60,8 @@ SET(APP_HDRS
     source/graphics/element_point_ranges_app.h
     source/graphics/environment_map_app.h
     source/finite_element/finite_element_region_app.h
+    source/finite_element/finite_element_list_file_app.hpp
+    source/finite_element/finite_element_renumber_app.hpp
     source/graphics/font_app.h
     source/graphics/scene_viewer_app.h
     source/graphics/glyph_app.h
@@ -66,6 +69,9 @@ SET(APP_HDRS
     source/graphics/tessellation_app.hpp
     source/computed_field/computed_field_app.h
     source/graphics/render_to_finite_elements_app.h
+    source/graphics/render_stl_app.h
+    source/graphics/render_wavefront_app.h
+    source/graphics/scene_transformation_table_app.h
     source/graphics/render_to_finite_elements_app.h
     source/graphics/auxiliary_graphics_types_app.h
     source/finite_element/finite_element_conversion_app.h
@@ -76,6 +82,7 @@ SET(APP_HDRS
     source/graphics/spectrum_component_app.h
     source/graphics/light_app.h
     source/computed_field/computed_field_set_app.h
+    source/general/memory_usage_app.h
     source/general/multi_range_app.h
     source/general/cmgui_time.h
     source/choose/choose_class.hpp
@@ -89,6 +96,7 @@ SET(APP_HDRS
     source/api/cmiss_fdio.h
     source/api/cmiss_idle.h
     source/comfile/comfile.h
+    source/command/background_job.h
     source/command/cmiss.h
     source/command/command.h
     source/command/console.h
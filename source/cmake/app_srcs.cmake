@@ -15,6 +15,7 @@ SET(APP_SRCS
     source/image_processing/computed_field_curvature_anisotropic_diffusion_image_filter_app.cpp
     source/image_processing/computed_field_histogram_image_filter_app.cpp
     source/image_processing/computed_field_discrete_gaussian_image_filter_app.cpp
+    source/image_processing/image_filter_app.cpp
     source/image_processing/computed_field_sigmoid_image_filter_app.cpp
     source/image_processing/computed_field_mean_image_filter_app.cpp
     source/image_processing/computed_field_canny_edge_detection_filter_app.cpp
@@ -49,9 +50,14 @@ SET(APP_SRCS
     source/graphics/element_point_ranges_app.cpp
     source/finite_element/export_finite_element_app.cpp
     source/graphics/render_to_finite_elements_app.cpp
+    source/graphics/render_stl_app.cpp
+    source/graphics/render_wavefront_app.cpp
+    source/graphics/scene_transformation_table_app.cpp
     source/finite_element/finite_element_conversion_app.cpp
     source/finite_element/finite_element_app.cpp
     source/finite_element/finite_element_region_app.cpp
+    source/finite_element/finite_element_list_file_app.cpp
+    source/finite_element/finite_element_renumber_app.cpp
     source/graphics/glyph_app.cpp
     source/graphics/graphics_app.cpp
     source/graphics/font_app.cpp
@@ -62,6 +68,7 @@ SET(APP_SRCS
     source/general/geometry_app.cpp
     source/computed_field/computed_field_app.cpp
     source/computed_field/computed_field_set_app.cpp
+    source/general/memory_usage_app.cpp
     source/general/multi_range_app.cpp
     source/general/cmgui_time.cpp
     source/graphics/auxiliary_graphics_types_app.cpp
@@ -76,6 +83,7 @@ SET(APP_SRCS
     source/graphics/scene_viewer_app.cpp
     source/cmgui.cpp
     source/comfile/comfile.cpp
+    source/command/background_job.cpp
     source/command/cmiss.cpp
     source/command/command.cpp
     source/command/console.cpp
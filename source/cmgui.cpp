@@ -111,6 +111,7 @@ int WINAPI WinMain(HINSTANCE current_instance,HINSTANCE previous_instance,
 	struct User_interface_module *UI_module = NULL;
 	struct cmzn_command_data *command_data;
 
+	cmzn_command_data_record_program_start_time();
 #if !defined (WIN32_USER_INTERFACE) && !defined (_MSC_VER)
 	ENTER(main);
 #else /* !defined (WIN32_USER_INTERFACE)  && !defined (_MSC_VER)*/
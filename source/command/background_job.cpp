@@ -0,0 +1,479 @@
+/*******************************************************************************
+FILE : background_job.cpp
+
+DESCRIPTION :
+External programs run by the system command without blocking cmgui.
+==============================================================================*/
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <map>
+#include <string>
+#include "configure/cmgui_configure.h"
+#if !defined (WIN32_SYSTEM)
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/select.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif /* !defined (WIN32_SYSTEM) */
+#include "general/debug.h"
+#include "general/message.h"
+#include "command/background_job.h"
+#include "user_interface/event_dispatcher.h"
+
+/*
+Module types
+------------
+*/
+
+namespace {
+
+/* interval between polls of running jobs for output and exit */
+const unsigned long BACKGROUND_JOB_POLL_NS = 100000000;
+
+/* number of polls to wait for a job to exit after SIGTERM before SIGKILL */
+const int BACKGROUND_JOB_TERMINATE_POLLS = 10;
+
+class Background_job
+{
+public:
+	const int id;
+	const std::string command;
+	bool finished;
+	int exit_status;
+#if !defined (WIN32_SYSTEM)
+	pid_t pid;
+	/* stdout and stderr pipes, -1 once closed */
+	int output_fd[2];
+	std::string partial_line[2];
+#endif /* !defined (WIN32_SYSTEM) */
+
+	Background_job(int idIn, const char *commandIn) :
+		id(idIn),
+		command(commandIn),
+		finished(false),
+		exit_status(0)
+#if !defined (WIN32_SYSTEM)
+		, pid(-1)
+#endif /* !defined (WIN32_SYSTEM) */
+	{
+#if !defined (WIN32_SYSTEM)
+		this->output_fd[0] = -1;
+		this->output_fd[1] = -1;
+#endif /* !defined (WIN32_SYSTEM) */
+	}
+
+	~Background_job()
+	{
+#if !defined (WIN32_SYSTEM)
+		for (int i = 0; i < 2; ++i)
+		{
+			if (0 <= this->output_fd[i])
+				close(this->output_fd[i]);
+		}
+#endif /* !defined (WIN32_SYSTEM) */
+	}
+
+#if !defined (WIN32_SYSTEM)
+	void writeLine(int stream, const std::string &line) const
+	{
+		display_message((0 == stream) ? INFORMATION_MESSAGE : WARNING_MESSAGE,
+			"[job %d] %s\n", this->id, line.c_str());
+	}
+
+	/** Reads available output from stream 0 (stdout) or 1 (stderr) without
+	 * blocking, writing complete lines. Closes the stream at end of file. */
+	void readOutput(int stream)
+	{
+		if (this->output_fd[stream] < 0)
+			return;
+		char buffer[4096];
+		while (true)
+		{
+			const ssize_t length = read(this->output_fd[stream], buffer, sizeof(buffer));
+			if (0 < length)
+			{
+				std::string &partial = this->partial_line[stream];
+				partial.append(buffer, length);
+				std::string::size_type line_start = 0, line_end;
+				while (std::string::npos != (line_end = partial.find('\n', line_start)))
+				{
+					this->writeLine(stream, partial.substr(line_start, line_end - line_start));
+					line_start = line_end + 1;
+				}
+				partial.erase(0, line_start);
+			}
+			else if ((length < 0) && ((errno == EAGAIN) || (errno == EINTR)))
+			{
+				break;
+			}
+			else
+			{
+				if (!this->partial_line[stream].empty())
+				{
+					this->writeLine(stream, this->partial_line[stream]);
+					this->partial_line[stream].clear();
+				}
+				close(this->output_fd[stream]);
+				this->output_fd[stream] = -1;
+				break;
+			}
+		}
+	}
+
+	/** Reads output and checks whether the job has exited.
+	 * @param block  If true, wait until the job has finished. */
+	void poll(bool block)
+	{
+		while (!this->finished)
+		{
+			this->readOutput(0);
+			this->readOutput(1);
+			int status = 0;
+			pid_t result;
+			do
+			{
+				result = waitpid(this->pid, &status, WNOHANG);
+			} while ((result < 0) && (errno == EINTR));
+			if (result == this->pid)
+			{
+				this->readOutput(0);
+				this->readOutput(1);
+				this->finished = true;
+				this->exit_status = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+				display_message(INFORMATION_MESSAGE,
+					"[job %d] Finished with exit status %d\n", this->id, this->exit_status);
+			}
+			else if (result < 0)
+			{
+				/* child already reaped */
+				this->finished = true;
+				this->exit_status = -1;
+			}
+			else if (block)
+			{
+				this->waitForOutput();
+			}
+			else
+			{
+				break;
+			}
+		}
+	}
+
+	/** Sleeps until output arrives or the next poll is due. */
+	void waitForOutput() const
+	{
+		fd_set read_set;
+		FD_ZERO(&read_set);
+		int max_fd = -1;
+		for (int i = 0; i < 2; ++i)
+		{
+			if (0 <= this->output_fd[i])
+			{
+				FD_SET(this->output_fd[i], &read_set);
+				if (this->output_fd[i] > max_fd)
+					max_fd = this->output_fd[i];
+			}
+		}
+		struct timeval timeout;
+		timeout.tv_sec = 0;
+		timeout.tv_usec = BACKGROUND_JOB_POLL_NS/1000;
+		select(max_fd + 1, &read_set, NULL, NULL, &timeout);
+	}
+
+	/** Terminates the job's process group if still running, sending SIGTERM
+	 * then SIGKILL if it has not exited after a number of polls. */
+	void terminate()
+	{
+		if (this->finished || (this->pid <= 0))
+			return;
+		display_message(WARNING_MESSAGE, "[job %d] Terminating: %s\n",
+			this->id, this->command.c_str());
+		kill(-this->pid, SIGTERM);
+		for (int i = 0; (i < BACKGROUND_JOB_TERMINATE_POLLS) && (!this->finished); ++i)
+		{
+			this->poll(/*block*/false);
+			if (!this->finished)
+				this->waitForOutput();
+		}
+		if (!this->finished)
+		{
+			kill(-this->pid, SIGKILL);
+			this->poll(/*block*/true);
+		}
+	}
+#endif /* !defined (WIN32_SYSTEM) */
+
+};
+
+typedef std::map<int, Background_job *> Background_job_map;
+
+}
+
+struct Background_job_list
+{
+	struct Event_dispatcher *event_dispatcher;
+	struct Event_dispatcher_timeout_callback *timeout_callback;
+	int next_job_id;
+	Background_job_map jobs;
+
+	Background_job_list(struct Event_dispatcher *event_dispatcherIn) :
+		event_dispatcher(event_dispatcherIn),
+		timeout_callback(0),
+		next_job_id(1)
+	{
+	}
+
+	~Background_job_list()
+	{
+		if (this->timeout_callback)
+			Event_dispatcher_remove_timeout_callback(this->event_dispatcher, this->timeout_callback);
+		for (Background_job_map::iterator iter = this->jobs.begin(); iter != this->jobs.end(); ++iter)
+		{
+#if !defined (WIN32_SYSTEM)
+			iter->second->terminate();
+#endif /* !defined (WIN32_SYSTEM) */
+			delete iter->second;
+		}
+	}
+
+	bool hasRunningJobs() const
+	{
+		for (Background_job_map::const_iterator iter = this->jobs.begin(); iter != this->jobs.end(); ++iter)
+		{
+			if (!iter->second->finished)
+				return true;
+		}
+		return false;
+	}
+
+	void pollAll()
+	{
+#if !defined (WIN32_SYSTEM)
+		for (Background_job_map::iterator iter = this->jobs.begin(); iter != this->jobs.end(); ++iter)
+			iter->second->poll(/*block*/false);
+#endif /* !defined (WIN32_SYSTEM) */
+	}
+
+	void schedulePoll();
+};
+
+/*
+Module functions
+----------------
+*/
+
+static int Background_job_list_timeout_callback(void *job_list_void)
+{
+	struct Background_job_list *job_list =
+		static_cast<struct Background_job_list *>(job_list_void);
+	if (job_list)
+	{
+		/* callback is destroyed after firing */
+		job_list->timeout_callback = 0;
+		job_list->pollAll();
+		job_list->schedulePoll();
+	}
+	return 1;
+}
+
+void Background_job_list::schedulePoll()
+{
+	if (this->event_dispatcher && (!this->timeout_callback) && this->hasRunningJobs())
+	{
+		this->timeout_callback = Event_dispatcher_add_timeout_callback(this->event_dispatcher,
+			/*timeout_s*/0, BACKGROUND_JOB_POLL_NS, Background_job_list_timeout_callback,
+			static_cast<void *>(this));
+	}
+}
+
+/*
+Global functions
+----------------
+*/
+
+struct Background_job_list *CREATE(Background_job_list)(
+	struct Event_dispatcher *event_dispatcher)
+{
+	return new Background_job_list(event_dispatcher);
+}
+
+int DESTROY(Background_job_list)(
+	struct Background_job_list **job_list_address)
+{
+	if (!(job_list_address && (*job_list_address)))
+	{
+		display_message(ERROR_MESSAGE,
+			"DESTROY(Background_job_list).  Invalid argument(s)");
+		return 0;
+	}
+	delete *job_list_address;
+	*job_list_address = 0;
+	return 1;
+}
+
+int Background_job_list_start(struct Background_job_list *job_list,
+	const char *command, int *job_id_address)
+{
+	if (!(job_list && command && job_id_address))
+	{
+		display_message(ERROR_MESSAGE,
+			"Background_job_list_start.  Invalid argument(s)");
+		return 0;
+	}
+	Background_job *job = new Background_job(job_list->next_job_id, command);
+#if defined (WIN32_SYSTEM)
+	display_message(WARNING_MESSAGE,
+		"system background:  Not supported on this platform; running to completion");
+	job->exit_status = system(command);
+	job->finished = true;
+#else /* defined (WIN32_SYSTEM) */
+	int pipe_fds[2][2];
+	if (0 != pipe(pipe_fds[0]))
+	{
+		display_message(ERROR_MESSAGE, "system background:  Could not create pipe");
+		delete job;
+		return 0;
+	}
+	if (0 != pipe(pipe_fds[1]))
+	{
+		display_message(ERROR_MESSAGE, "system background:  Could not create pipe");
+		close(pipe_fds[0][0]);
+		close(pipe_fds[0][1]);
+		delete job;
+		return 0;
+	}
+	job->pid = fork();
+	if (0 == job->pid)
+	{
+		/* child, in its own process group so commands it starts can be
+			 terminated with it */
+		setpgid(0, 0);
+		dup2(pipe_fds[0][1], STDOUT_FILENO);
+		dup2(pipe_fds[1][1], STDERR_FILENO);
+		for (int i = 0; i < 2; ++i)
+		{
+			close(pipe_fds[i][0]);
+			close(pipe_fds[i][1]);
+		}
+		execl("/bin/sh", "sh", "-c", command, (char *)NULL);
+		_exit(127);
+	}
+	if (0 < job->pid)
+	{
+		/* also set in the parent so the group exists before it is signalled */
+		setpgid(job->pid, job->pid);
+	}
+	for (int i = 0; i < 2; ++i)
+	{
+		close(pipe_fds[i][1]);
+		if (job->pid < 0)
+		{
+			close(pipe_fds[i][0]);
+		}
+		else
+		{
+			job->output_fd[i] = pipe_fds[i][0];
+			fcntl(job->output_fd[i], F_SETFL, fcntl(job->output_fd[i], F_GETFL) | O_NONBLOCK);
+			/* don't leak to later jobs */
+			fcntl(job->output_fd[i], F_SETFD, FD_CLOEXEC);
+		}
+	}
+	if (job->pid < 0)
+	{
+		display_message(ERROR_MESSAGE, "system background:  Could not start '%s'", command);
+		delete job;
+		return 0;
+	}
+#endif /* defined (WIN32_SYSTEM) */
+	job_list->jobs[job->id] = job;
+	*job_id_address = job->id;
+	++(job_list->next_job_id);
+	job_list->schedulePoll();
+	return 1;
+}
+
+int Background_job_list_wait(struct Background_job_list *job_list,
+	int job_id)
+{
+	if (!job_list)
+	{
+		display_message(ERROR_MESSAGE,
+			"Background_job_list_wait.  Invalid argument(s)");
+		return 0;
+	}
+	int return_code = 1;
+	Background_job_map::iterator iter = (0 == job_id) ?
+		job_list->jobs.begin() : job_list->jobs.find(job_id);
+	if ((0 != job_id) && (iter == job_list->jobs.end()))
+	{
+		display_message(ERROR_MESSAGE, "system wait:  No job %d", job_id);
+		return 0;
+	}
+	while (iter != job_list->jobs.end())
+	{
+		Background_job *job = iter->second;
+#if !defined (WIN32_SYSTEM)
+		job->poll(/*block*/true);
+#endif /* !defined (WIN32_SYSTEM) */
+		if (0 != job->exit_status)
+			return_code = 0;
+		delete job;
+		job_list->jobs.erase(iter++);
+		if (0 != job_id)
+			break;
+	}
+	return (return_code);
+}
+
+int Background_job_list_poll(struct Background_job_list *job_list)
+{
+	if (!job_list)
+	{
+		display_message(ERROR_MESSAGE,
+			"Background_job_list_poll.  Invalid argument(s)");
+		return 0;
+	}
+	job_list->pollAll();
+	return 1;
+}
+
+int Background_job_list_list(struct Background_job_list *job_list)
+{
+	if (!job_list)
+	{
+		display_message(ERROR_MESSAGE,
+			"Background_job_list_list.  Invalid argument(s)");
+		return 0;
+	}
+	job_list->pollAll();
+	if (job_list->jobs.empty())
+	{
+		display_message(INFORMATION_MESSAGE, "No background jobs\n");
+		return 1;
+	}
+	for (Background_job_map::iterator iter = job_list->jobs.begin(); iter != job_list->jobs.end(); ++iter)
+	{
+		Background_job *job = iter->second;
+		if (job->finished)
+		{
+			display_message(INFORMATION_MESSAGE, "[job %d] finished (%d): %s\n",
+				job->id, job->exit_status, job->command.c_str());
+		}
+		else
+		{
+			display_message(INFORMATION_MESSAGE, "[job %d] running: %s\n",
+				job->id, job->command.c_str());
+		}
+	}
+	return 1;
+}
@@ -0,0 +1,82 @@
+/*******************************************************************************
+FILE : background_job.h
+
+DESCRIPTION :
+External programs run by the system command without blocking cmgui.
+==============================================================================*/
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+#if !defined (BACKGROUND_JOB_H)
+#define BACKGROUND_JOB_H
+
+#include "general/object.h"
+
+struct Event_dispatcher;
+
+/*
+Global types
+------------
+*/
+
+struct Background_job_list;
+/*******************************************************************************
+DESCRIPTION :
+Running and finished background jobs, each identified by a positive job id.
+Output of running jobs is polled from a timeout callback on the event
+dispatcher and after each command, and written line by line as information (stdout) or warning
+(stderr) messages prefixed by the job id.
+==============================================================================*/
+
+/*
+Global functions
+----------------
+*/
+
+struct Background_job_list *CREATE(Background_job_list)(
+	struct Event_dispatcher *event_dispatcher);
+
+int DESTROY(Background_job_list)(
+	struct Background_job_list **job_list_address);
+/*******************************************************************************
+DESCRIPTION :
+Terminates any jobs still running, writing their remaining output. Each job's
+process group is sent SIGTERM, then SIGKILL if it has not exited after a short
+wait, so no job is left writing to a pipe nobody reads.
+==============================================================================*/
+
+int Background_job_list_start(struct Background_job_list *job_list,
+	const char *command, int *job_id_address);
+/*******************************************************************************
+DESCRIPTION :
+Runs <command> through the shell in the background, returning its id in
+<*job_id_address>. On platforms without fork the command is run to completion
+before returning.
+==============================================================================*/
+
+int Background_job_list_wait(struct Background_job_list *job_list,
+	int job_id);
+/*******************************************************************************
+DESCRIPTION :
+Waits for job <job_id>, or all jobs if <job_id> is 0, to finish, writing
+their remaining output, then forgets them.
+Returns 1 if all jobs waited for exited with status 0, otherwise 0.
+==============================================================================*/
+
+int Background_job_list_poll(struct Background_job_list *job_list);
+/*******************************************************************************
+DESCRIPTION :
+Writes output available from running jobs and reports any that have finished,
+without blocking. Called after each command as the polling timeout does not
+fire while command files are executing.
+==============================================================================*/
+
+int Background_job_list_list(struct Background_job_list *job_list);
+/*******************************************************************************
+DESCRIPTION :
+Lists the id, state and command of each job not yet waited for.
+==============================================================================*/
+
+#endif /* !defined (BACKGROUND_JOB_H) */
@@ -13,14 +13,18 @@
 #include "configure/cmgui_configure.h"
 #endif /* defined (BUILD_WITH_CMAKE) */
 
+#include <ctype.h>
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <set>
 #include <string>
+#include <vector>
 #if defined (WIN32_SYSTEM)
 #  include <direct.h>
 #else /* !defined (WIN32_SYSTEM) */
 #  include <unistd.h>
+#  include <sys/resource.h>
 #endif /* !defined (WIN32_SYSTEM) */
 #include <math.h>
 #include <time.h>
@@ -50,6 +54,7 @@
 #if defined (WX_USER_INTERFACE)
 #include "comfile/comfile_window_wx.h"
 #endif /* defined (WX_USER_INTERFACE) */
+#include "command/background_job.h"
 #include "command/console.h"
 #include "command/command_window.h"
 #include "command/example_path.h"
@@ -105,11 +110,14 @@
 #include "finite_element/finite_element_to_streamlines.h"
 #include "finite_element/import_finite_element.h"
 #include "finite_element/snake.h"
+#include "general/cmgui_time.h"
 #include "general/debug.h"
 #include "general/error_handler.h"
+#include "general/geometry.h"
 #include "general/image_utilities.h"
 #include "general/io_stream.h"
 #include "general/matrix_vector.h"
+#include "general/memory_usage_app.h"
 #include "general/multi_range.h"
 #include "general/mystring.h"
 #include "graphics/environment_map.h"
@@ -228,6 +236,7 @@
 #include "computed_field/computed_field_time_app.h"
 #include "image_processing/computed_field_binary_threshold_image_filter_app.h"
 #include "image_processing/computed_field_threshold_image_filter_app.h"
+#include "image_processing/image_filter_app.h"
 #include "image_processing/computed_field_image_resample_app.h"
 #include "computed_field/computed_field_string_constant_app.h"
 #include "computed_field/computed_field_deformation_app.h"
@@ -254,6 +263,8 @@
 #include "graphics/element_point_ranges_app.h"
 #include "graphics/environment_map_app.h"
 #include "finite_element/finite_element_region_app.h"
+#include "finite_element/finite_element_list_file_app.hpp"
+#include "finite_element/finite_element_renumber_app.hpp"
 #include "graphics/scene_viewer_app.h"
 #include "graphics/font_app.h"
 #include "graphics/glyph_app.h"
@@ -263,6 +274,9 @@
 #include "computed_field/computed_field_app.h"
 #include "general/enumerator_app.h"
 #include "graphics/render_to_finite_elements_app.h"
+#include "graphics/render_stl_app.h"
+#include "graphics/render_wavefront_app.h"
+#include "graphics/scene_transformation_table_app.h"
 #include "graphics/auxiliary_graphics_types_app.h"
 #include "finite_element/finite_element_conversion_app.h"
 #include "graphics/texture_app.h"
@@ -344,6 +358,11 @@ DESCRIPTION :
 	struct MANAGER(Scene) *scene_manager;
 	struct Scene *default_scene;
 	struct MANAGER(cmzn_spectrum) *spectrum_manager;
+	struct Spectrum_autorange_cache *spectrum_autorange_cache;
+	struct Minimise_package *minimise_package;
+	struct Scene_transformation_table *scene_transformation_table;
+	struct Background_job_list *background_job_list;
+	struct Region_path_cache *region_path_cache;
 	struct MANAGER(VT_volume_texture) *volume_texture_manager;
 	/* global list of selected objects */
 	struct Element_point_ranges_selection *element_point_ranges_selection;
@@ -498,7 +517,9 @@ LAST MODIFIED : 17 January 2003
 DESCRIPTION :
 ==============================================================================*/
 {
-	char data_flag, element_flag, face_flag, line_flag, node_flag, *sort_by_field_name;
+	char data_flag, element_flag, face_flag, line_flag, node_flag, order_flag,
+		*sort_by_field_name;
+	enum Space_filling_curve_type curve_type;
 	FE_value time;
 	int data_offset, element_offset, face_offset, line_offset, node_offset,
 		return_code;
@@ -523,6 +544,8 @@ DESCRIPTION :
 		line_offset = 0;
 		node_flag = 0;
 		node_offset = 0;
+		order_flag = 0;
+		curve_type = SPACE_FILLING_CURVE_HILBERT;
 		sort_by_field_name = NULL;
 		sort_by_field = (struct Computed_field *)NULL;
 		if (command_data->default_time_keeper_app)
@@ -552,6 +575,9 @@ DESCRIPTION :
 		/* node_offset */
 		Option_table_add_entry(option_table, "node_offset", &node_offset,
 			&node_flag, set_int_and_char_flag);
+		/* order */
+		Option_table_add_entry(option_table, "order", &curve_type,
+			&order_flag, set_Space_filling_curve_type);
 		/* sort_by */
 		Option_table_add_string_entry(option_table, "sort_by", &sort_by_field_name,
 			" FIELD_NAME");
@@ -585,11 +611,42 @@ DESCRIPTION :
 					}
 					cmzn_fieldmodule_destroy(&field_module);
 				}
+				if (return_code && order_flag)
+				{
+					if (!sort_by_field)
+					{
+						display_message(ERROR_MESSAGE,
+							"gfx change_identifier.  Order requires a sort_by field");
+						return_code = 0;
+					}
+					else if ((cmzn_field_get_number_of_components(sort_by_field) > 3) ||
+						(cmzn_field_get_value_type(sort_by_field) != CMZN_FIELD_VALUE_TYPE_REAL))
+					{
+						display_message(ERROR_MESSAGE,
+							"gfx change_identifier.  Order requires a real sort_by field with at most 3 components");
+						return_code = 0;
+					}
+				}
 				if (return_code)
 				{
 					int highest_dimension = FE_region_get_highest_dimension(fe_region);
 					cmzn_fieldmodule_id fieldmodule = cmzn_region_get_fieldmodule(region);
 					cmzn_fieldmodule_begin_change(fieldmodule);
+					/* with a space filling curve order, nodes and elements share the
+						box it spans so element order follows node order */
+					double minimums[3], maximums[3];
+					double *curve_minimums = 0, *curve_maximums = 0;
+					if (order_flag)
+					{
+						cmzn_nodeset_id nodes = cmzn_fieldmodule_find_nodeset_by_field_domain_type(
+							fieldmodule, CMZN_FIELD_DOMAIN_TYPE_NODES);
+						if (cmzn_nodeset_get_field_range(nodes, sort_by_field, time, minimums, maximums))
+						{
+							curve_minimums = minimums;
+							curve_maximums = maximums;
+						}
+						cmzn_nodeset_destroy(&nodes);
+					}
 					if (element_flag)
 					{
 						if (highest_dimension > 0)
@@ -598,7 +655,19 @@ DESCRIPTION :
 								fieldmodule, highest_dimension);
 							cmzn_field_element_group_id element_group =
 								cmzn_field_group_get_field_element_group(group, mesh);
-							if (CMZN_OK != FE_region_change_element_identifiers(fe_region,
+							if (order_flag)
+							{
+								cmzn_mesh_id renumber_mesh = element_group ?
+									cmzn_mesh_group_base_cast(cmzn_field_element_group_get_mesh_group(element_group)) :
+									cmzn_mesh_access(mesh);
+								if (!cmzn_mesh_change_element_identifiers_space_filling_curve(renumber_mesh,
+									element_offset, sort_by_field, time, curve_type, curve_minimums, curve_maximums))
+								{
+									return_code = 0;
+								}
+								cmzn_mesh_destroy(&renumber_mesh);
+							}
+							else if (CMZN_OK != FE_region_change_element_identifiers(fe_region,
 								highest_dimension, element_offset, sort_by_field, time,
 								element_group))
 							{
@@ -619,8 +688,20 @@ DESCRIPTION :
 							fieldmodule, 2);
 						cmzn_field_element_group_id element_group =
 							cmzn_field_group_get_field_element_group(group, mesh);
-						if (CMZN_OK != FE_region_change_element_identifiers(fe_region,
-							/*dimension*/2,	face_offset, sort_by_field, time,
+						if (order_flag)
+						{
+							cmzn_mesh_id renumber_mesh = element_group ?
+								cmzn_mesh_group_base_cast(cmzn_field_element_group_get_mesh_group(element_group)) :
+								cmzn_mesh_access(mesh);
+							if (!cmzn_mesh_change_element_identifiers_space_filling_curve(renumber_mesh,
+								face_offset, sort_by_field, time, curve_type, curve_minimums, curve_maximums))
+							{
+								return_code = 0;
+							}
+							cmzn_mesh_destroy(&renumber_mesh);
+						}
+						else if (CMZN_OK != FE_region_change_element_identifiers(fe_region,
+							/*dimension*/2, face_offset, sort_by_field, time,
 							element_group))
 						{
 							return_code = 0;
@@ -634,7 +715,19 @@ DESCRIPTION :
 							fieldmodule, 1);
 						cmzn_field_element_group_id element_group =
 							cmzn_field_group_get_field_element_group(group, mesh);
-						if (CMZN_OK != FE_region_change_element_identifiers(fe_region,
+						if (order_flag)
+						{
+							cmzn_mesh_id renumber_mesh = element_group ?
+								cmzn_mesh_group_base_cast(cmzn_field_element_group_get_mesh_group(element_group)) :
+								cmzn_mesh_access(mesh);
+							if (!cmzn_mesh_change_element_identifiers_space_filling_curve(renumber_mesh,
+								line_offset, sort_by_field, time, curve_type, curve_minimums, curve_maximums))
+							{
+								return_code = 0;
+							}
+							cmzn_mesh_destroy(&renumber_mesh);
+						}
+						else if (CMZN_OK != FE_region_change_element_identifiers(fe_region,
 							/*dimension*/1, line_offset, sort_by_field, time,
 							element_group))
 						{
@@ -656,7 +749,13 @@ DESCRIPTION :
 						}
 						if (nodeset)
 						{
-							if (!cmzn_nodeset_change_node_identifiers(nodeset, node_offset, sort_by_field, time))
+							if (order_flag)
+							{
+								if (!cmzn_nodeset_change_node_identifiers_space_filling_curve(nodeset,
+									node_offset, sort_by_field, time, curve_type, curve_minimums, curve_maximums))
+									return_code = 0;
+							}
+							else if (!cmzn_nodeset_change_node_identifiers(nodeset, node_offset, sort_by_field, time))
 								return_code = 0;
 							cmzn_nodeset_destroy(&nodeset);
 						}
@@ -674,7 +773,13 @@ DESCRIPTION :
 						}
 						if (nodeset)
 						{
-							if (!cmzn_nodeset_change_node_identifiers(nodeset, data_offset, sort_by_field, time))
+							if (order_flag)
+							{
+								if (!cmzn_nodeset_change_node_identifiers_space_filling_curve(nodeset,
+									data_offset, sort_by_field, time, curve_type, /*minimums*/0, /*maximums*/0))
+									return_code = 0;
+							}
+							else if (!cmzn_nodeset_change_node_identifiers(nodeset, data_offset, sort_by_field, time))
 								return_code = 0;
 							cmzn_nodeset_destroy(&nodeset);
 						}
@@ -1378,8 +1483,37 @@ static int gfx_create_gauss_points(struct Parse_state *state,
 			}
 			if (return_code)
 			{
+				struct timeval start_time, end_time;
+				const int old_size = cmzn_nodeset_get_size(gauss_points_nodeset);
+				cmgui_gettimeofday(&start_time, (struct timezone *)NULL);
+				/* cache changes so graphics and other clients are notified once
+					after all points are created, not per node and field value */
+				cmzn_fieldmodule_begin_change(field_module);
 				return_code = cmzn_mesh_create_gauss_points(mesh, order, gauss_points_nodeset,
 					first_identifier, gauss_location_field, gauss_weight_field);
+				cmzn_fieldmodule_end_change(field_module);
+				cmgui_gettimeofday(&end_time, (struct timezone *)NULL);
+				const int number_of_points = cmzn_nodeset_get_size(gauss_points_nodeset) - old_size;
+				const double elapsed_time = cmgui_get_elapsed_seconds(&start_time, &end_time);
+				if (return_code)
+				{
+					if (elapsed_time > 0.0)
+					{
+						display_message(INFORMATION_MESSAGE,
+							"gfx create gauss_points:  Created %d points in %g s (%g points/s)\n",
+							number_of_points, elapsed_time, (double)number_of_points/elapsed_time);
+					}
+					else
+					{
+						display_message(INFORMATION_MESSAGE,
+							"gfx create gauss_points:  Created %d points\n", number_of_points);
+					}
+				}
+				else
+				{
+					display_message(ERROR_MESSAGE,
+						"gfx create gauss_points:  Failed after creating %d points", number_of_points);
+				}
 			}
 			cmzn_field_finite_element_destroy(&gauss_weight_field);
 			cmzn_field_stored_mesh_location_destroy(&gauss_location_field);
@@ -1897,7 +2031,7 @@ DESCRIPTION :
 Executes a GFX CREATE SNAKE command.
 ==============================================================================*/
 {
-	char *source_region_path;
+	char *source_region_path, timing_flag;
 	float density_factor, stiffness;
 	int i, number_of_elements, number_of_fitting_fields,
 		previous_state_index, return_code;
@@ -1923,6 +2057,7 @@ Executes a GFX CREATE SNAKE command.
 		density_factor = 0.0;
 		number_of_elements = 1;
 		stiffness = 0.0;
+		timing_flag = 0;
 
 		if (strcmp(PARSER_HELP_STRING,state->current_token)&&
 			strcmp(PARSER_RECURSIVE_HELP_STRING,state->current_token))
@@ -1996,6 +2131,8 @@ Executes a GFX CREATE SNAKE command.
 		/* stiffness */
 		Option_table_add_entry(option_table, "stiffness",
 			&stiffness, NULL, set_float_non_negative);
+		/* timing */
+		Option_table_add_char_flag_entry(option_table, "timing", &timing_flag);
 		/* weight_field */
 		set_weight_field_data.conditional_function =
 			Computed_field_is_scalar;
@@ -2068,6 +2205,8 @@ Executes a GFX CREATE SNAKE command.
 					cmzn_field_element_group_destroy(&element_group);
 					cmzn_mesh_destroy(&master_mesh);
 				}
+				struct timeval start_time, end_time;
+				cmgui_gettimeofday(&start_time, (struct timezone *)NULL);
 				return_code = create_FE_element_snake_from_data_points(
 					fe_region, coordinate_field, weight_field,
 					number_of_fitting_fields, fitting_fields,
@@ -2075,6 +2214,14 @@ Executes a GFX CREATE SNAKE command.
 					number_of_elements,
 					density_factor,
 					stiffness, nodeset_group, mesh_group);
+				cmgui_gettimeofday(&end_time, (struct timezone *)NULL);
+				if (return_code && timing_flag)
+				{
+					display_message(INFORMATION_MESSAGE,
+						"gfx create snake:  Created %d elements from %d data points in %g seconds\n",
+						number_of_elements, cmzn_nodeset_get_size(source_nodeset),
+						cmgui_get_elapsed_seconds(&start_time, &end_time));
+				}
 				cmzn_mesh_group_destroy(&mesh_group);
 				cmzn_nodeset_group_destroy(&nodeset_group);
 				cmzn_fieldmodule_end_change(target_fieldmodule);
@@ -2136,10 +2283,11 @@ I would put this with the other gfx modify routines but then it can't be
 static and referred to by gfx_create_Spectrum
 ==============================================================================*/
 {
-	char autorange, blue_to_red, blue_white_red, clear, lg_blue_to_red,
+	char all_times, autorange, blue_to_red, blue_white_red, clear, lg_blue_to_red,
 		lg_red_to_blue, overlay_colour, overwrite_colour, red_to_blue;
 	const char *current_token;
-	int process, return_code;
+	double default_end_time, default_start_time, end_time, start_time;
+	int number_of_time_steps, process, return_code;
 	struct cmzn_command_data *command_data;
 	struct Modify_spectrum_app_data modify_spectrum_data;
 	struct Option_table *option_table;
@@ -2242,8 +2390,19 @@ static and referred to by gfx_create_Spectrum
 				}
 				if (process)
 				{
+					all_times = 0;
 					autorange = 0;
 					autorange_scene = ACCESS(Scene)(command_data->default_scene);
+					start_time = 0.0;
+					end_time = 0.0;
+					if (command_data->default_time_keeper_app)
+					{
+						start_time = command_data->default_time_keeper_app->getTimeKeeper()->getMinimum();
+						end_time = command_data->default_time_keeper_app->getTimeKeeper()->getMaximum();
+					}
+					default_start_time = start_time;
+					default_end_time = end_time;
+					number_of_time_steps = 0;
 					blue_to_red = 0;
 					clear = 0;
 					lg_blue_to_red = 0;
@@ -2264,6 +2423,15 @@ static and referred to by gfx_create_Spectrum
 					cmzn_scenefilter_id filter =
 						cmzn_scenefiltermodule_get_default_scenefilter(command_data->filter_module);
 					option_table=CREATE(Option_table)();
+					Option_table_add_help(option_table,
+						"[autorange] sets the spectrum minimum and maximum to the range of data "
+						"displayed with it in graphics of the [scene_for_autorange] and its children, "
+						"at the current time only unless [all_times] or [number_of_time_steps] is "
+						"specified. With [all_times] the range is found over [number_of_time_steps] "
+						"equally spaced times from [start_time] to [end_time], which default to the "
+						"timekeeper minimum, maximum and time step; they are an error otherwise. Ranges "
+						"at each time are cached and reused until fields, graphics or tessellations change.");
+					Option_table_add_char_flag_entry(option_table,"all_times",&all_times);
 					Option_table_add_entry(option_table,"autorange",&autorange,NULL,
 						set_char_flag);
 					Option_table_add_entry(option_table,"blue_to_red",&blue_to_red,NULL,
@@ -2272,6 +2440,8 @@ static and referred to by gfx_create_Spectrum
 						set_char_flag);
 					Option_table_add_entry(option_table,"clear",&clear,NULL,
 						set_char_flag);
+					Option_table_add_entry(option_table,"end_time",&end_time,
+						NULL,set_double);
 					Option_table_add_entry(option_table,"field",&modify_spectrum_data,
 						NULL,gfx_modify_spectrum_settings_field);
 					Option_table_add_entry(option_table, "filter", &filter,
@@ -2288,6 +2458,8 @@ static and referred to by gfx_create_Spectrum
 						NULL,set_Spectrum_maximum_command);
 					Option_table_add_entry(option_table,"minimum",&spectrum_to_be_modified_copy,
 						NULL,set_Spectrum_minimum_command);
+					Option_table_add_entry(option_table, "number_of_time_steps", &number_of_time_steps,
+						&number_of_time_steps, set_int_non_negative);
 					Option_table_add_entry(option_table,"overlay_colour",&overlay_colour,
 						NULL,set_char_flag);
 					Option_table_add_entry(option_table,"overwrite_colour",&overwrite_colour,
@@ -2296,8 +2468,18 @@ static and referred to by gfx_create_Spectrum
 						command_data->root_region,set_Scene);
 					Option_table_add_entry(option_table,"red_to_blue",&red_to_blue,
 						NULL,set_char_flag);
+					Option_table_add_entry(option_table,"start_time",&start_time,
+						NULL,set_double);
 					if (0 != (return_code = Option_table_multi_parse(option_table, state)))
 					{
+						if (((start_time != default_start_time) || (end_time != default_end_time)) &&
+							!(autorange && (all_times || (number_of_time_steps > 0))))
+						{
+							display_message(ERROR_MESSAGE,
+								"gfx_modify_Spectrum.  start_time and end_time are only used by "
+								"autorange with all_times or number_of_time_steps");
+							return_code = 0;
+						}
 						if (return_code)
 						{
 							if ( clear )
@@ -2360,7 +2542,44 @@ static and referred to by gfx_create_Spectrum
 								cmzn_spectrum_set_material_overwrite(spectrum_to_be_modified_copy,
 									1);
 							}
-							if (autorange)
+							if (autorange && spectrum_to_be_modified &&
+								(all_times || (number_of_time_steps > 0)) &&
+								command_data->default_time_keeper_app)
+							{
+								double maximum, minimum;
+								if (0 == number_of_time_steps)
+								{
+									const double time_step =
+										command_data->default_time_keeper_app->getTimeStep();
+									number_of_time_steps = 1;
+									if ((time_step > 0.0) && (end_time > start_time))
+									{
+										number_of_time_steps +=
+											(int)((end_time - start_time)/time_step + 0.5);
+									}
+								}
+								int old_hit_count = 0, old_miss_count = 0, hit_count = 0, miss_count = 0;
+								Spectrum_autorange_cache_get_statistics(command_data->spectrum_autorange_cache,
+									&old_hit_count, &old_miss_count);
+								int maxRanges = cmzn_scene_get_spectrum_data_range_over_time(
+									autorange_scene, filter, spectrum_to_be_modified,
+									command_data->default_time_keeper_app->getTimeKeeper(),
+									start_time, end_time, number_of_time_steps,
+									command_data->spectrum_autorange_cache,
+									/*valuesCount*/1, &minimum, &maximum);
+								Spectrum_autorange_cache_get_statistics(command_data->spectrum_autorange_cache,
+									&hit_count, &miss_count);
+								display_message(INFORMATION_MESSAGE,
+									"Autorange over %d times from %g to %g: %d cached, %d evaluated\n",
+									number_of_time_steps, start_time, end_time,
+									hit_count - old_hit_count, miss_count - old_miss_count);
+								if ( maxRanges >= 1 )
+								{
+									Spectrum_set_minimum_and_maximum(spectrum_to_be_modified_copy,
+										minimum, maximum );
+								}
+							}
+							else if (autorange)
 							{
 								double maximum, minimum;
 								int maxRanges = cmzn_scene_get_spectrum_data_range(autorange_scene,
@@ -2641,16 +2860,52 @@ Currently limited to 1 byte per component.
 		use_pixel_location = (texture_coordinate_field == source_texture_coordinate_field);
 		field_name = (char *)NULL;
 		GET_NAME(Computed_field)(field, &field_name);
-		if (Texture_allocate_image(texture, image_width, image_height,
+		double texture_width, texture_height, texture_depth;
+		Texture_get_physical_size(texture, &texture_width, &texture_height, &texture_depth);
+		/* images from chains of image filters sampled at pixel locations depend
+			 only on the filter definitions, source images and spectrum, so can be
+			 reused from the image filter cache */
+		Image_filter_cache_key cache_key = 0;
+		if (use_pixel_location && Image_filter_cache_is_enabled())
+		{
+			cache_key = IMAGE_FILTER_CACHE_KEY_START;
+			if (Image_filter_cache_key_add_field(&cache_key, field) &&
+				Image_filter_cache_key_add_spectrum(&cache_key, spectrum))
+			{
+				/* texture coordinates are assigned pixel locations, not evaluated */
+				char *coordinate_field_name = cmzn_field_get_name(texture_coordinate_field);
+				cache_key = Image_filter_cache_key_add_bytes(cache_key,
+					coordinate_field_name, strlen(coordinate_field_name) + 1);
+				DEALLOCATE(coordinate_field_name);
+				const int sizes[6] = { image_width, image_height, image_depth,
+					static_cast<int>(storage), number_of_bytes_per_component, propagate_field };
+				cache_key = Image_filter_cache_key_add_bytes(cache_key, sizes, sizeof(sizes));
+				const double physical_size[3] = { texture_width, texture_height, texture_depth };
+				cache_key = Image_filter_cache_key_add_bytes(cache_key,
+					physical_size, sizeof(physical_size));
+			}
+			else
+			{
+				cache_key = 0;
+			}
+		}
+		if (cache_key && Image_filter_cache_read(cache_key, texture, field_name))
+		{
+			/* image set from cache */
+		}
+		else if (Texture_allocate_image(texture, image_width, image_height,
 			image_depth, storage, number_of_bytes_per_component, field_name))
 		{
+			Image_filter_record_field_evaluation(field);
 			bytes_per_pixel = number_of_components*number_of_bytes_per_component;
-			double texture_width, texture_height, texture_depth;
-			Texture_get_physical_size(texture, &texture_width, &texture_height, &texture_depth);
 			Set_cmiss_field_value_to_texture(field, texture_coordinate_field,
 				texture, spectrum,	fail_material, image_width, image_height, image_depth,
 				bytes_per_pixel, number_of_bytes_per_component, use_pixel_location, texture_width, texture_height, texture_depth,
 				storage, propagate_field, Graphics_buffer_package_get_core_package(graphics_buffer_package), search_mesh);
+			if (cache_key)
+			{
+				Image_filter_cache_write(cache_key, texture);
+			}
 		}
 		else
 		{
@@ -4469,6 +4724,7 @@ Executes a GFX CONVERT ELEMENTS command.
 			Convert_finite_elements_mode conversion_mode = CONVERT_TO_FINITE_ELEMENTS_MODE_UNSPECIFIED;
 			double tolerance = 1.0E-6;
 			Element_discretization element_refinement = { 1, 1, 1 };
+			char timing_flag = 0;
 
 			if ((state->current_token) &&
 				strcmp(PARSER_HELP_STRING,state->current_token) &&
@@ -4512,7 +4768,8 @@ Executes a GFX CONVERT ELEMENTS command.
 				"Note: field value versions of non-coordinate fields are not handled"
 				" - the first processed element's versions are assumed. "
 				"Mode \'convert_hermite_2D_product_elements\' ONLY: converts element fields on 2-D elements "
-				"into bicubic hermite basis WITHOUT merging nearby nodes.");
+				"into bicubic hermite basis WITHOUT merging nearby nodes. "
+				"Option \'timing\' reports the number of elements converted and the time taken.");
 			Option_table_add_set_cmzn_region(option_table, "destination_region",
 				command_data->root_region, &destination_region);
 			Option_table_add_entry(option_table,"fields",component_names,
@@ -4525,6 +4782,7 @@ Executes a GFX CONVERT ELEMENTS command.
 				(void *)&element_refinement, (void *)NULL, set_Element_discretization);
 			Option_table_add_set_cmzn_region(option_table, "source_region",
 				command_data->root_region, &source_region);
+			Option_table_add_char_flag_entry(option_table, "timing", &timing_flag);
 			Option_table_add_non_negative_double_entry(option_table, "tolerance", &tolerance);
 			return_code=Option_table_multi_parse(option_table,state);
 			DESTROY(Option_table)(&option_table);
@@ -4599,9 +4857,58 @@ Executes a GFX CONVERT ELEMENTS command.
 					refinement.count[0] = element_refinement.number_in_xi1;
 					refinement.count[1] = element_refinement.number_in_xi2;
 					refinement.count[2] = element_refinement.number_in_xi3;
+					/* destination sizes before, to report only what conversion adds */
+					cmzn_fieldmodule_id destination_field_module = cmzn_region_get_fieldmodule(destination_region);
+					cmzn_nodeset_id destination_nodes = cmzn_fieldmodule_find_nodeset_by_field_domain_type(
+						destination_field_module, CMZN_FIELD_DOMAIN_TYPE_NODES);
+					int destination_mesh_sizes[MAXIMUM_ELEMENT_XI_DIMENSIONS];
+					for (i = 0; i < MAXIMUM_ELEMENT_XI_DIMENSIONS; i++)
+					{
+						cmzn_mesh_id destination_mesh = cmzn_fieldmodule_find_mesh_by_dimension(
+							destination_field_module, i + 1);
+						destination_mesh_sizes[i] = cmzn_mesh_get_size(destination_mesh);
+						cmzn_mesh_destroy(&destination_mesh);
+					}
+					const int destination_nodes_size = cmzn_nodeset_get_size(destination_nodes);
+					struct timeval start_time, end_time;
+					cmgui_gettimeofday(&start_time, (struct timezone *)NULL);
+					/* cache changes so graphics and other clients are notified once
+						after all elements are converted, not per node and element */
+					cmzn_region_begin_hierarchical_change(destination_region);
 					return_code = finite_element_conversion(
 						source_region, destination_region, conversion_mode,
 						number_of_fields, fields, refinement, tolerance);
+					cmzn_region_end_hierarchical_change(destination_region);
+					cmgui_gettimeofday(&end_time, (struct timezone *)NULL);
+					if (return_code && timing_flag)
+					{
+						const double elapsed_time = cmgui_get_elapsed_seconds(&start_time, &end_time);
+						cmzn_fieldmodule_id source_field_module = cmzn_region_get_fieldmodule(source_region);
+						const int source_dimension = FE_region_get_highest_dimension(
+							cmzn_region_get_FE_region(source_region));
+						const int destination_dimension = FE_region_get_highest_dimension(
+							cmzn_region_get_FE_region(destination_region));
+						cmzn_mesh_id source_mesh = cmzn_fieldmodule_find_mesh_by_dimension(
+							source_field_module, source_dimension);
+						cmzn_mesh_id destination_mesh = cmzn_fieldmodule_find_mesh_by_dimension(
+							destination_field_module, destination_dimension);
+						const int number_of_source_elements = cmzn_mesh_get_size(source_mesh);
+						const int number_of_new_elements = cmzn_mesh_get_size(destination_mesh) -
+							(((0 < destination_dimension) && (destination_dimension <= MAXIMUM_ELEMENT_XI_DIMENSIONS)) ?
+								destination_mesh_sizes[destination_dimension - 1] : 0);
+						display_message(INFORMATION_MESSAGE,
+							"gfx convert elements:  %d %d-D elements converted to %d new %d-D elements and "
+							"%d new nodes in %g seconds (%g source elements/s)\n",
+							number_of_source_elements, source_dimension, number_of_new_elements,
+							destination_dimension, cmzn_nodeset_get_size(destination_nodes) - destination_nodes_size,
+							elapsed_time,
+							(elapsed_time > 0.0) ? (double)number_of_source_elements/elapsed_time : 0.0);
+						cmzn_mesh_destroy(&destination_mesh);
+						cmzn_mesh_destroy(&source_mesh);
+						cmzn_fieldmodule_destroy(&source_field_module);
+					}
+					cmzn_nodeset_destroy(&destination_nodes);
+					cmzn_fieldmodule_destroy(&destination_field_module);
 				}
 			}
 			if (fields)
@@ -4685,7 +4992,9 @@ static int gfx_convert_graphics(struct Parse_state *state,
 			"The surface_density gives the base expected number of points per unit area, and if the "
 			"graphics has a data field, the value of its first component scaled by surface_density_scale_factor "
 			"is added to the expected number. Separate values for lines control the expected number per unit length. "
-			"With mode 'render_nodes', nodes are created at points.");
+			"With mode 'render_nodes', nodes are created at points. "
+			"For the node modes, a positive merge_tolerance removes new nodes within that "
+			"distance of another node. Option 'timing' reports the nodes created and time taken.");
 		/* coordinate */
 		Option_table_add_string_entry(option_table,"coordinate",&coordinate_field_name,
 			" FIELD_NAME");
@@ -4694,6 +5003,8 @@ static int gfx_convert_graphics(struct Parse_state *state,
 		double line_density_scale_factor = 0.0;
 		Option_table_add_double_entry(option_table, "line_density_scale_factor", &line_density_scale_factor);
 
+		double merge_tolerance = 0.0;
+		Option_table_add_non_negative_double_entry(option_table, "merge_tolerance", &merge_tolerance);
 		/* render_to_finite_elements_mode */
 		OPTION_TABLE_ADD_ENUMERATOR(Render_to_finite_elements_mode)(option_table,
 			&render_mode);
@@ -4708,11 +5019,19 @@ static int gfx_convert_graphics(struct Parse_state *state,
 		Option_table_add_double_entry(option_table, "surface_density", &surface_density);
 		double surface_density_scale_factor = 0.0;
 		Option_table_add_double_entry(option_table, "surface_density_scale_factor", &surface_density_scale_factor);
+		char timing_flag = 0;
+		Option_table_add_char_flag_entry(option_table, "timing", &timing_flag);
 		return_code=Option_table_multi_parse(option_table,state);
 		DESTROY(Option_table)(&option_table);
 
 		if (return_code)
 		{
+			if ((0.0 < merge_tolerance) && (RENDER_TO_FINITE_ELEMENTS_LINEAR_PRODUCT == render_mode))
+			{
+				display_message(ERROR_MESSAGE,
+					"gfx_convert_graphics.  merge_tolerance is only supported for node modes.");
+				return_code = 0;
+			}
 			if (scene_path_name)
 			{
 				export_object_name_parser(scene_path_name, &scene_name,
@@ -4767,9 +5086,44 @@ static int gfx_convert_graphics(struct Parse_state *state,
 
 		if (return_code)
 		{
+			struct timeval start_time, end_time;
+			cmgui_gettimeofday(&start_time, (struct timezone *)NULL);
+			cmzn_fieldmodule_id field_module = cmzn_region_get_fieldmodule(region);
+			cmzn_nodeset_id nodeset = cmzn_fieldmodule_find_nodeset_by_field_domain_type(
+				field_module, CMZN_FIELD_DOMAIN_TYPE_NODES);
+			const int old_number_of_nodes = cmzn_nodeset_get_size(nodeset);
+			std::vector<int> existing_node_identifiers;
+			if (0.0 < merge_tolerance)
+				cmzn_nodeset_get_node_identifiers(nodeset, existing_node_identifiers);
+			/* cache changes so graphics and other clients are notified once
+				after all nodes and elements are created and merged */
+			cmzn_region_begin_hierarchical_change(region);
 			render_to_finite_elements(input_region, graphics_name, filter, render_mode,
 				region, group, coordinate_field, static_cast<cmzn_nodeset_id>(0),
 				line_density, line_density_scale_factor, surface_density, surface_density_scale_factor);
+			const int number_of_nodes_created = cmzn_nodeset_get_size(nodeset) - old_number_of_nodes;
+			int number_of_nodes_merged = 0;
+			if (0.0 < merge_tolerance)
+			{
+				double time = 0.0;
+				if (command_data->default_time_keeper_app)
+					time = command_data->default_time_keeper_app->getTimeKeeper()->getTime();
+				number_of_nodes_merged = cmzn_nodeset_merge_added_coincident_nodes(nodeset,
+					coordinate_field, time, existing_node_identifiers, merge_tolerance);
+				if (number_of_nodes_merged < 0)
+					return_code = 0;
+			}
+			cmzn_region_end_hierarchical_change(region);
+			cmgui_gettimeofday(&end_time, (struct timezone *)NULL);
+			if (timing_flag)
+			{
+				display_message(INFORMATION_MESSAGE,
+					"gfx convert graphics:  %d nodes created, %d merged, in %g seconds\n",
+					number_of_nodes_created, (number_of_nodes_merged > 0) ? number_of_nodes_merged : 0,
+					cmgui_get_elapsed_seconds(&start_time, &end_time));
+			}
+			cmzn_nodeset_destroy(&nodeset);
+			cmzn_fieldmodule_destroy(&field_module);
 		}
 		if (scene)
 		{
@@ -7081,10 +7435,18 @@ Executes a GFX EXPORT STL command.
 		if (NULL != (command_data = (struct cmzn_command_data *)command_data_void))
 		{
 			file_name = (char *)NULL;
+			char binary_flag = 0;
 			scene = cmzn_scene_access(command_data->default_scene);
 			cmzn_scenefilter_id filter =
 				cmzn_scenefiltermodule_get_default_scenefilter(command_data->filter_module);
 			option_table = CREATE(Option_table)();
+			Option_table_add_help(option_table,
+				"Write the surfaces of the scene and its child scenes passing the filter "
+				"to an STL file. Option 'binary' writes binary STL, which is about a "
+				"fifth of the size of ASCII STL, and reports the number of triangles, "
+				"bytes written and time taken.");
+			/* binary */
+			Option_table_add_char_flag_entry(option_table, "binary", &binary_flag);
 			/* file */
 			Option_table_add_entry(option_table, "file", &file_name,
 				(void *)1, set_name);
@@ -7097,7 +7459,24 @@ Executes a GFX EXPORT STL command.
 			{
 				if (scene)
 				{
-					if (file_name)
+					if (file_name && binary_flag)
+					{
+						struct timeval start_time, end_time;
+						int number_of_triangles = 0;
+						unsigned long long number_of_bytes = 0;
+						cmgui_gettimeofday(&start_time, (struct timezone *)NULL);
+						return_code = export_to_binary_stl(file_name, scene, filter,
+							&number_of_triangles, &number_of_bytes);
+						cmgui_gettimeofday(&end_time, (struct timezone *)NULL);
+						if (return_code)
+						{
+							display_message(INFORMATION_MESSAGE,
+								"gfx export stl:  Wrote %d triangles, %llu bytes to %s in %g seconds\n",
+								number_of_triangles, number_of_bytes, file_name,
+								cmgui_get_elapsed_seconds(&start_time, &end_time));
+						}
+					}
+					else if (file_name)
 					{
 						return_code = export_to_stl(file_name, scene, filter);
 					}
@@ -7411,7 +7790,8 @@ Executes a GFX EXPORT WAVEFRONT command.
 ==============================================================================*/
 {
 	const char *file_ext = ".obj";
-	char *file_name,full_comments;
+	char *file_name,full_comments,time_series;
+	double end_time, start_time;
 	int frame_number, number_of_frames, return_code, version;
 	struct cmzn_command_data *command_data;
 	struct Scene *scene = NULL;
@@ -7425,6 +7805,9 @@ Executes a GFX EXPORT WAVEFRONT command.
 		{"scene",NULL,NULL,set_Scene},
 		{"version",NULL,NULL,set_int_positive},
 		{"filter",NULL,NULL,set_cmzn_scenefilter},
+		{"end_time",NULL,NULL,set_double},
+		{"start_time",NULL,NULL,set_double},
+		{"time_series",NULL,NULL,set_char_flag},
 		{NULL,NULL,NULL,NULL}
 	};
 	ENTER(gfx_export_wavefront);
@@ -7442,6 +7825,14 @@ Executes a GFX EXPORT WAVEFRONT command.
 			scene=cmzn_scene_access(command_data->default_scene);
 			filter=cmzn_scenefiltermodule_get_default_scenefilter(command_data->filter_module);
 			version=3;
+			time_series=0;
+			start_time=0.0;
+			end_time=0.0;
+			if (command_data->default_time_keeper_app)
+			{
+				start_time = command_data->default_time_keeper_app->getTimeKeeper()->getMinimum();
+				end_time = command_data->default_time_keeper_app->getTimeKeeper()->getMaximum();
+			}
 			(option_table[0]).to_be_modified= &file_name;
 			(option_table[1]).to_be_modified= &frame_number;
 			(option_table[2]).to_be_modified= &full_comments;
@@ -7450,6 +7841,9 @@ Executes a GFX EXPORT WAVEFRONT command.
 			(option_table[4]).user_data=command_data->scene_manager;
 			(option_table[5]).to_be_modified= &version;
 			(option_table[6]).to_be_modified= &filter;
+			(option_table[7]).to_be_modified= &end_time;
+			(option_table[8]).to_be_modified= &start_time;
+			(option_table[9]).to_be_modified= &time_series;
 			return_code=process_multiple_options(state,option_table);
 			/* no errors, not asking for help */
 
@@ -7471,7 +7865,17 @@ Executes a GFX EXPORT WAVEFRONT command.
 					{
 						strcat(file_name, file_ext);
 					}
-					return_code=export_to_wavefront(file_name, scene, filter, full_comments);
+					if (time_series)
+					{
+						/* faces are written once with vertices per frame */
+						return_code = export_to_wavefront_time_series(file_name, scene, filter,
+							full_comments, command_data->default_time_keeper_app,
+							start_time, end_time, number_of_frames);
+					}
+					else
+					{
+						return_code=export_to_wavefront(file_name, scene, filter, full_comments);
+					}
 				}
 			} /* parse error,help */
 			cmzn_scene_destroy(&scene);
@@ -8731,10 +9135,18 @@ Executes a GFX LIST ELEMENT.
 		char verbose_flag = 0;
 		Multi_range *element_ranges = CREATE(Multi_range)();
 		char *conditional_field_name = 0;
+		char *file_name = 0;
+		enum FE_list_file_format file_format = FE_LIST_FILE_FORMAT_CSV;
 
 		Option_table *option_table = CREATE(Option_table)();
 		/* all (redundant option) */
 		Option_table_add_entry(option_table, "all", &all_flag, NULL, set_char_flag);
+		/* file */
+		Option_table_add_string_entry(option_table, "file", &file_name,
+			" FILE_NAME");
+		/* format */
+		Option_table_add_entry(option_table, "format", &file_format,
+			NULL, set_FE_list_file_format);
 		/* region */
 		Option_table_add_set_cmzn_region(option_table, "region",
 			command_data->root_region, &region);
@@ -8804,11 +9216,26 @@ Executes a GFX LIST ELEMENT.
 				{
 					iteration_mesh = cmzn_mesh_group_base_cast(selection_mesh_group);
 				}
+				FE_list_file_writer *file_writer = 0;
+				if (file_name)
+				{
+					file_writer = new FE_list_file_writer(file_name, file_format, field_module,
+						command_data->default_time_keeper_app ?
+						command_data->default_time_keeper_app->getTimeKeeper()->getTime() : 0.0);
+					if (!file_writer->isValid())
+					{
+						delete file_writer;
+						file_writer = 0;
+						iteration_mesh = 0;
+						return_code = 0;
+					}
+				}
 				const bool use_element_ranges = Multi_range_get_number_of_ranges(element_ranges) > 0;
 				if (Multi_range_get_total_number_in_ranges(element_ranges) == 1)
 					verbose_flag = 1;
 				Multi_range *output_element_ranges = CREATE(Multi_range)();
-				cmzn_elementiterator_id iter = cmzn_mesh_create_elementiterator(iteration_mesh);
+				cmzn_elementiterator_id iter = iteration_mesh ?
+					cmzn_mesh_create_elementiterator(iteration_mesh) : 0;
 				cmzn_element_id element = 0;
 				while (NULL != (element = cmzn_elementiterator_next_non_access(iter)))
 				{
@@ -8820,7 +9247,11 @@ Executes a GFX LIST ELEMENT.
 						if (!cmzn_field_evaluate_boolean(conditional_field, cache))
 							continue;
 					}
-					if (verbose_flag)
+					if (file_writer)
+					{
+						file_writer->addElement(element);
+					}
+					else if (verbose_flag)
 					{
 						if (!list_FE_element(region, field_module, master_mesh, element))
 							break;
@@ -8833,7 +9264,18 @@ Executes a GFX LIST ELEMENT.
 					++number_of_elements_listed;
 				}
 				cmzn_elementiterator_destroy(&iter);
-				if ((!verbose_flag) && number_of_elements_listed)
+				if (file_writer)
+				{
+					return_code = file_writer->finish();
+					if (return_code)
+					{
+						display_message(INFORMATION_MESSAGE,
+							"Wrote %d values at each of %d elements to %s\n",
+							file_writer->getNumberOfColumns(), number_of_elements_listed, file_name);
+					}
+					delete file_writer;
+				}
+				else if ((!verbose_flag) && number_of_elements_listed)
 				{
 					if (dimension == 1)
 					{
@@ -8853,7 +9295,7 @@ Executes a GFX LIST ELEMENT.
 				DESTROY(Multi_range)(&output_element_ranges);
 				cmzn_fieldcache_destroy(&cache);
 			}
-			if (0 == number_of_elements_listed)
+			if (return_code && (0 == number_of_elements_listed))
 			{
 				if (dimension == 1)
 				{
@@ -8876,6 +9318,8 @@ Executes a GFX LIST ELEMENT.
 		cmzn_field_destroy(&conditional_field);
 		if (conditional_field_name)
 			DEALLOCATE(conditional_field_name);
+		if (file_name)
+			DEALLOCATE(file_name);
 		cmzn_region_destroy(&region);
 	}
 	else
@@ -8908,10 +9352,18 @@ use node_manager and node_selection.
 		char verbose_flag = 0;
 		Multi_range *node_ranges = CREATE(Multi_range)();
 		char *conditional_field_name = 0;
+		char *file_name = 0;
+		enum FE_list_file_format file_format = FE_LIST_FILE_FORMAT_CSV;
 
 		Option_table *option_table = CREATE(Option_table)();
 		/* all (redundant option) */
 		Option_table_add_entry(option_table, "all", &all_flag, NULL, set_char_flag);
+		/* file */
+		Option_table_add_string_entry(option_table, "file", &file_name,
+			" FILE_NAME");
+		/* format */
+		Option_table_add_entry(option_table, "format", &file_format,
+			NULL, set_FE_list_file_format);
 		/* region */
 		Option_table_add_set_cmzn_region(option_table, "region",
 			command_data->root_region, &region);
@@ -8977,11 +9429,26 @@ use node_manager and node_selection.
 				{
 					iteration_nodeset = cmzn_nodeset_group_base_cast(selection_nodeset_group);
 				}
+				FE_list_file_writer *file_writer = 0;
+				if (file_name)
+				{
+					file_writer = new FE_list_file_writer(file_name, file_format, field_module,
+						command_data->default_time_keeper_app ?
+						command_data->default_time_keeper_app->getTimeKeeper()->getTime() : 0.0);
+					if (!file_writer->isValid())
+					{
+						delete file_writer;
+						file_writer = 0;
+						iteration_nodeset = 0;
+						return_code = 0;
+					}
+				}
 				const bool use_node_ranges = Multi_range_get_number_of_ranges(node_ranges) > 0;
 				if (Multi_range_get_total_number_in_ranges(node_ranges) == 1)
 					verbose_flag = 1;
 				Multi_range *output_node_ranges = CREATE(Multi_range)();
-				cmzn_nodeiterator_id iter = cmzn_nodeset_create_nodeiterator(iteration_nodeset);
+				cmzn_nodeiterator_id iter = iteration_nodeset ?
+					cmzn_nodeset_create_nodeiterator(iteration_nodeset) : 0;
 				cmzn_node_id node = 0;
 				while (NULL != (node = cmzn_nodeiterator_next_non_access(iter)))
 				{
@@ -8993,7 +9460,11 @@ use node_manager and node_selection.
 						if (!cmzn_field_evaluate_boolean(conditional_field, cache))
 							continue;
 					}
-					if (verbose_flag)
+					if (file_writer)
+					{
+						file_writer->addNode(node);
+					}
+					else if (verbose_flag)
 					{
 						list_FE_node(node);
 					}
@@ -9005,7 +9476,19 @@ use node_manager and node_selection.
 					++number_of_nodes_listed;
 				}
 				cmzn_nodeiterator_destroy(&iter);
-				if ((!verbose_flag) && number_of_nodes_listed)
+				if (file_writer)
+				{
+					return_code = file_writer->finish();
+					if (return_code)
+					{
+						display_message(INFORMATION_MESSAGE,
+							"Wrote %d values at each of %d %s to %s\n",
+							file_writer->getNumberOfColumns(), number_of_nodes_listed,
+							use_data ? "data points" : "nodes", file_name);
+					}
+					delete file_writer;
+				}
+				else if ((!verbose_flag) && number_of_nodes_listed)
 				{
 					display_message(INFORMATION_MESSAGE, use_data ? "Data:\n" : "Nodes:\n");
 					return_code = Multi_range_display_ranges(output_node_ranges);
@@ -9014,7 +9497,7 @@ use node_manager and node_selection.
 				DESTROY(Multi_range)(&output_node_ranges);
 				cmzn_fieldcache_destroy(&cache);
 			}
-			if (0 == number_of_nodes_listed)
+			if (return_code && (0 == number_of_nodes_listed))
 			{
 				display_message(INFORMATION_MESSAGE,
 					use_data ? "gfx list data:  No data specified\n" : "gfx list nodes:  No nodes specified\n");
@@ -9027,6 +9510,8 @@ use node_manager and node_selection.
 		cmzn_field_destroy(&conditional_field);
 		if (conditional_field_name)
 			DEALLOCATE(conditional_field_name);
+		if (file_name)
+			DEALLOCATE(file_name);
 		cmzn_region_destroy(&region);
 	}
 	else
@@ -9534,6 +10019,116 @@ use node_manager and node_selection.
 	return (return_code);
 } /* gfx_list_grid_points */
 
+/***************************************************************************//**
+ * Lists the state of the image filter cache and its hit and miss counts.
+ */
+static int gfx_list_image_filter_cache(struct Parse_state *state,
+	void *dummy_to_be_modified, void *dummy_user_data)
+{
+	int return_code = 0;
+	USE_PARAMETER(dummy_to_be_modified);
+	USE_PARAMETER(dummy_user_data);
+	if (state)
+	{
+		Option_table *option_table = CREATE(Option_table)();
+		Option_table_add_help(option_table,
+			"List the image filter cache directory, size, and hit and miss counts.");
+		return_code = Option_table_multi_parse(option_table, state);
+		DESTROY(Option_table)(&option_table);
+		if (return_code)
+			return_code = Image_filter_cache_list();
+	}
+	return (return_code);
+}
+
+/***************************************************************************//**
+ * Lists the number of threads used by ITK image filters.
+ */
+static int gfx_list_image_filter_threads(struct Parse_state *state,
+	void *dummy_to_be_modified, void *dummy_user_data)
+{
+	int return_code = 0;
+	USE_PARAMETER(dummy_to_be_modified);
+	USE_PARAMETER(dummy_user_data);
+	if (state)
+	{
+		Option_table *option_table = CREATE(Option_table)();
+		Option_table_add_help(option_table,
+			"List the number of threads used by ITK image filters.");
+		return_code = Option_table_multi_parse(option_table, state);
+		DESTROY(Option_table)(&option_table);
+		if (return_code)
+		{
+			const int number_of_threads = Image_filter_get_number_of_threads();
+			if (number_of_threads)
+			{
+				display_message(INFORMATION_MESSAGE,
+					"Image filter threads: %d\n", number_of_threads);
+			}
+			else
+			{
+				display_message(INFORMATION_MESSAGE,
+					"Image filter threads: ITK default\n");
+			}
+		}
+	}
+	return (return_code);
+}
+
+/***************************************************************************//**
+ * Lists memory used by the process, and by a region and its subregions, their
+ * scenes and textures, and by the image filter cache.
+ */
+static int gfx_list_memory_usage(struct Parse_state *state,
+	void *dummy_to_be_modified, void *root_region_void)
+{
+	int return_code = 0;
+	USE_PARAMETER(dummy_to_be_modified);
+	cmzn_region_id root_region = static_cast<cmzn_region_id>(root_region_void);
+	if (state && root_region)
+	{
+		cmzn_region_id region = cmzn_region_access(root_region);
+		char csv_flag = 0;
+		Option_table *option_table = CREATE(Option_table)();
+		Option_table_add_help(option_table,
+			"List memory used by the process, and for the region and its subregions: "
+			"numbers of nodes, data points, elements and fields, bytes of node field "
+			"values (a lower bound), numbers of graphics in scenes and bytes of image "
+			"field texels. Also lists the disk used by the image filter cache. "
+			"Use 'csv' to output lines of SECTION,NAME,QUANTITY,VALUE for other tools.");
+		Option_table_add_char_flag_entry(option_table, "csv", &csv_flag);
+		Option_table_add_set_cmzn_region(option_table, "region", root_region, &region);
+		return_code = Option_table_multi_parse(option_table, state);
+		DESTROY(Option_table)(&option_table);
+		if (return_code)
+			return_code = list_memory_usage(region, static_cast<int>(csv_flag));
+		cmzn_region_destroy(&region);
+	}
+	return (return_code);
+}
+
+/***************************************************************************//**
+ * Lists the state of the region path cache and its hit and miss counts.
+ */
+static int gfx_list_region_path_cache(struct Parse_state *state,
+	void *dummy_to_be_modified, void *region_path_cache_void)
+{
+	int return_code = 0;
+	struct Region_path_cache *region_path_cache;
+	USE_PARAMETER(dummy_to_be_modified);
+	if (state && (region_path_cache = static_cast<struct Region_path_cache *>(region_path_cache_void)))
+	{
+		Option_table *option_table = CREATE(Option_table)();
+		Option_table_add_help(option_table,
+			"List the number of region paths cached, and hit, miss and invalidation counts.");
+		return_code = Option_table_multi_parse(option_table, state);
+		DESTROY(Option_table)(&option_table);
+		if (return_code)
+			return_code = Region_path_cache_list(region_path_cache);
+	}
+	return (return_code);
+}
+
 static int gfx_list_light(struct Parse_state *state,
 	void *dummy_to_be_modified,void *light_manager_void)
 /*******************************************************************************
@@ -9963,31 +10558,74 @@ Executes a GFX LIST TRANSFORMATION.
 	return (return_code);
 } /* gfx_list_transformation */
 
-#if defined (SGI_MOVIE_FILE)
-static int gfx_list_movie_graphics(struct Parse_state *state,
-	void *dummy_to_be_modified,void *movie_graphics_manager_void)
-/*******************************************************************************
-LAST MODIFIED : 3 February 2000
-
-DESCRIPTION :
-Executes a GFX LIST MOVIE.
-==============================================================================*/
+/***************************************************************************//**
+ * Lists the size and update statistics of the scene transformation table.
+ */
+static int gfx_list_transformation_table(struct Parse_state *state,
+	void *dummy_to_be_modified, void *command_data_void)
 {
-	const char *current_token;
-	int return_code;
-	struct Movie_graphics *movie;
-	struct MANAGER(Movie_graphics) *movie_graphics_manager;
+	int return_code = 0;
 
-	ENTER(gfx_list_movie_graphics);
+	ENTER(gfx_list_transformation_table);
 	USE_PARAMETER(dummy_to_be_modified);
-	if (state)
+	struct cmzn_command_data *command_data = (struct cmzn_command_data *)command_data_void;
+	if (state && command_data)
 	{
-		if (movie_graphics_manager=
-			(struct MANAGER(Movie_graphics) *)movie_graphics_manager_void)
+		Option_table *option_table = CREATE(Option_table)();
+		Option_table_add_help(option_table,
+			"List the number of regions and transformations in the table read "
+			"with gfx set transformation_table, and the number and duration of "
+			"its updates on time changes.");
+		return_code = Option_table_multi_parse(option_table, state);
+		DESTROY(Option_table)(&option_table);
+		if (return_code)
 		{
-			if (NULL != (current_token = state->current_token))
+			if (command_data->scene_transformation_table)
 			{
-				if (strcmp(PARSER_HELP_STRING,current_token)&&
+				return_code = Scene_transformation_table_list(
+					command_data->scene_transformation_table);
+			}
+			else
+			{
+				display_message(INFORMATION_MESSAGE, "Transformation table is empty\n");
+			}
+		}
+	}
+	else
+	{
+		display_message(ERROR_MESSAGE,
+			"gfx_list_transformation_table.  Invalid argument(s)");
+	}
+	LEAVE;
+
+	return (return_code);
+}
+
+#if defined (SGI_MOVIE_FILE)
+static int gfx_list_movie_graphics(struct Parse_state *state,
+	void *dummy_to_be_modified,void *movie_graphics_manager_void)
+/*******************************************************************************
+LAST MODIFIED : 3 February 2000
+
+DESCRIPTION :
+Executes a GFX LIST MOVIE.
+==============================================================================*/
+{
+	const char *current_token;
+	int return_code;
+	struct Movie_graphics *movie;
+	struct MANAGER(Movie_graphics) *movie_graphics_manager;
+
+	ENTER(gfx_list_movie_graphics);
+	USE_PARAMETER(dummy_to_be_modified);
+	if (state)
+	{
+		if (movie_graphics_manager=
+			(struct MANAGER(Movie_graphics) *)movie_graphics_manager_void)
+		{
+			if (NULL != (current_token = state->current_token))
+			{
+				if (strcmp(PARSER_HELP_STRING,current_token)&&
 					strcmp(PARSER_RECURSIVE_HELP_STRING,current_token))
 				{
 					if (movie=FIND_BY_IDENTIFIER_IN_MANAGER(Movie_graphics,name)(
@@ -10184,6 +10822,12 @@ Executes a GFX LIST command.
 			/* group */
 			Option_table_add_entry(option_table, "group", (void *)0,
 				command_data->root_region, gfx_list_group);
+			/* image_filter_cache */
+			Option_table_add_entry(option_table, "image_filter_cache", NULL,
+				NULL, gfx_list_image_filter_cache);
+			/* image_filter_threads */
+			Option_table_add_entry(option_table, "image_filter_threads", NULL,
+				NULL, gfx_list_image_filter_threads);
 			/* light */
 			Option_table_add_entry(option_table, "light", NULL,
 				cmzn_lightmodule_get_manager(command_data->lightmodule), gfx_list_light);
@@ -10196,6 +10840,12 @@ Executes a GFX LIST command.
 			/* material */
 			Option_table_add_entry(option_table, "material", NULL,
 				cmzn_materialmodule_get_manager(command_data->materialmodule), gfx_list_graphical_material);
+			/* memory_usage */
+			Option_table_add_entry(option_table, "memory_usage", NULL,
+				command_data->root_region, gfx_list_memory_usage);
+			/* minimise */
+			Option_table_add_entry(option_table, "minimise", NULL,
+				(void *)command_data->minimise_package, gfx_list_minimise);
 #if defined (SGI_MOVIE_FILE)
 			/* movie */
 			Option_table_add_entry(option_table, "movie", NULL,
@@ -10207,6 +10857,9 @@ Executes a GFX LIST command.
 			/* region */
 			Option_table_add_entry(option_table, "region", NULL,
 				command_data->root_region, gfx_list_region);
+			/* region_path_cache */
+			Option_table_add_entry(option_table, "region_path_cache", NULL,
+				(void *)command_data->region_path_cache, gfx_list_region_path_cache);
 			/* scene */
 			Option_table_add_entry(option_table, "scene", NULL,
 				command_data->root_region, gfx_list_scene);
@@ -10222,6 +10875,9 @@ Executes a GFX LIST command.
 			/* transformation */
 			Option_table_add_entry(option_table, "transformation", NULL,
 				command_data_void, gfx_list_transformation);
+			/* transformation_table */
+			Option_table_add_entry(option_table, "transformation_table", NULL,
+				command_data_void, gfx_list_transformation_table);
 #if defined (USE_CMGUI_GRAPHICS_WINDOW)
 			/* graphics window */
 			Option_table_add_entry(option_table, "window", NULL,
@@ -11484,6 +12140,230 @@ Which tool that is being modified is passed in <node_tool_void>.
 			  (WIN32_USER_INTERFACE) || defined (CARBON_USER_INTERFACE) || defined(WX_USER_INTERFACE */
 
 #if defined (GTK_USER_INTERFACE) || defined (WIN32_USER_INTERFACE) || defined (WX_USER_INTERFACE)
+/** An image to print with its window and view, read from a gfx print views
+ * file. Values not given on the line keep the window's view. */
+struct Gfx_print_view
+{
+	char *file_name;
+	struct Graphics_window *window;
+	double eye[3], lookat[3], up[3];
+	/* eye, lookat and up are only used if set; view angle if in (0,180) */
+	int eye_set, lookat_set, up_set;
+	double view_angle;
+};
+
+/** View of the first pane of a window, saved to restore after printing. */
+struct Gfx_print_window_view
+{
+	struct Graphics_window *window;
+	double eye[3], lookat[3], up[3];
+	double view_angle;
+};
+
+/**
+ * Reads the gfx print views file, one line per image, ignoring blank lines
+ * and those starting with #. Each line has the form:
+ * IMAGE_FILE [window NAME] [eye_point X Y Z] [interest_point X Y Z]
+ * [up_vector X Y Z] [view_angle DEGREES]
+ * Windows in views are accessed and their original views saved.
+ */
+static int gfx_print_read_views(const char *views_file_name,
+	struct Graphics_window *default_window,
+	struct MANAGER(Graphics_window) *graphics_window_manager,
+	std::vector<Gfx_print_view> &views,
+	std::vector<Gfx_print_window_view> &window_views)
+{
+	FILE *views_file = fopen(views_file_name, "r");
+	if (!views_file)
+	{
+		display_message(ERROR_MESSAGE,
+			"gfx print:  Could not open views file %s", views_file_name);
+		return 0;
+	}
+	int return_code = 1;
+	int line_number = 0;
+	std::string line;
+	int c = 0;
+	while (return_code && (EOF != c))
+	{
+		line.clear();
+		while ((EOF != (c = fgetc(views_file))) && ('\n' != c))
+			line += static_cast<char>(c);
+		++line_number;
+		const std::string::size_type start = line.find_first_not_of(" \t\r");
+		if ((std::string::npos == start) || ('#' == line[start]))
+			continue;
+		Gfx_print_view view;
+		view.file_name = 0;
+		view.window = default_window ? ACCESS(Graphics_window)(default_window) : 0;
+		view.eye[0] = view.eye[1] = view.eye[2] = 0.0;
+		view.lookat[0] = view.lookat[1] = view.lookat[2] = 0.0;
+		view.up[0] = view.up[1] = view.up[2] = 0.0;
+		view.view_angle = -1.0;
+		struct Set_vector_with_help_data
+			eye_data = {3, " X Y Z", 0},
+			lookat_data = {3, " X Y Z", 0},
+			up_data = {3, " X Y Z", 0};
+		struct Parse_state *state = create_Parse_state(line.c_str());
+		struct Option_table *option_table = CREATE(Option_table)();
+		Option_table_add_double_vector_with_help_entry(option_table, "eye_point",
+			view.eye, &eye_data);
+		Option_table_add_double_vector_with_help_entry(option_table, "interest_point",
+			view.lookat, &lookat_data);
+		Option_table_add_double_vector_with_help_entry(option_table, "up_vector",
+			view.up, &up_data);
+		Option_table_add_double_entry(option_table, "view_angle", &view.view_angle);
+		Option_table_add_entry(option_table, "window",
+			&view.window, graphics_window_manager, set_Graphics_window);
+		Option_table_add_default_string_entry(option_table, &view.file_name, "IMAGE_FILE");
+		return_code = state && Option_table_multi_parse(option_table, state);
+		DESTROY(Option_table)(&option_table);
+		if (state)
+			destroy_Parse_state(&state);
+		view.eye_set = eye_data.set;
+		view.lookat_set = lookat_data.set;
+		view.up_set = up_data.set;
+		if (return_code && !(view.file_name && view.window))
+		{
+			display_message(ERROR_MESSAGE,
+				"gfx print:  Missing image file name or window");
+			return_code = 0;
+		}
+		if (return_code)
+		{
+			views.push_back(view);
+			size_t w = 0;
+			while ((w < window_views.size()) && (window_views[w].window != view.window))
+				++w;
+			if (w == window_views.size())
+			{
+				Gfx_print_window_view window_view;
+				window_view.window = ACCESS(Graphics_window)(view.window);
+				struct Scene_viewer_app *scene_viewer =
+					Graphics_window_get_Scene_viewer(view.window, /*pane_no*/0);
+				cmzn_sceneviewer_get_lookat_parameters(scene_viewer->core_scene_viewer,
+					window_view.eye, window_view.lookat, window_view.up);
+				window_view.view_angle = cmzn_sceneviewer_get_view_angle(scene_viewer->core_scene_viewer);
+				window_views.push_back(window_view);
+			}
+		}
+		else
+		{
+			display_message(ERROR_MESSAGE,
+				"gfx print:  Invalid view at line %d of %s", line_number, views_file_name);
+			if (view.window)
+				DEACCESS(Graphics_window)(&view.window);
+			if (view.file_name)
+				DEALLOCATE(view.file_name);
+		}
+	}
+	fclose(views_file);
+	return return_code;
+}
+
+/**
+ * Prints each view to its image file. All views of a window share one
+ * print batch so its scene is built once and the offscreen buffer reused for
+ * views of the same size. The windows' original views are restored after.
+ */
+static int gfx_print_views(const char *views_file_name,
+	struct Graphics_window *default_window, struct cmzn_command_data *command_data,
+	enum Image_file_format image_file_format, int force_onscreen, int width,
+	int height, int antialias, int transparency_layers,
+	enum Texture_storage_type storage)
+{
+	std::vector<Gfx_print_view> views;
+	std::vector<Gfx_print_window_view> window_views;
+	int return_code = gfx_print_read_views(views_file_name, default_window,
+		command_data->graphics_window_manager, views, window_views);
+	struct timeval start_time, end_time;
+	cmgui_gettimeofday(&start_time, (struct timezone *)NULL);
+	size_t w;
+	for (w = 0; w < window_views.size(); ++w)
+		Graphics_window_begin_print_batch(window_views[w].window);
+	size_t number_of_images = 0;
+	for (size_t v = 0; return_code && (v < views.size()); ++v)
+	{
+		const Gfx_print_view &view = views[v];
+		for (w = 0; window_views[w].window != view.window; ++w)
+			;
+		const Gfx_print_window_view &window_view = window_views[w];
+		struct Scene_viewer_app *scene_viewer =
+			Graphics_window_get_Scene_viewer(view.window, /*pane_no*/0);
+		double eye[3], lookat[3], up[3];
+		for (int i = 0; i < 3; ++i)
+		{
+			eye[i] = view.eye_set ? view.eye[i] : window_view.eye[i];
+			lookat[i] = view.lookat_set ? view.lookat[i] : window_view.lookat[i];
+			up[i] = view.up_set ? view.up[i] : window_view.up[i];
+		}
+		cmzn_sceneviewer_begin_change(scene_viewer->core_scene_viewer);
+		cmzn_sceneviewer_set_lookat_parameters_non_skew(scene_viewer->core_scene_viewer,
+			eye, lookat, up);
+		/* must set view angle after lookat parameters */
+		cmzn_sceneviewer_set_view_angle(scene_viewer->core_scene_viewer,
+			((0.0 < view.view_angle) && (view.view_angle < 180.0)) ?
+				view.view_angle*(PI/180.0) : window_view.view_angle);
+		cmzn_sceneviewer_end_change(scene_viewer->core_scene_viewer);
+		struct Cmgui_image_information *cmgui_image_information =
+			CREATE(Cmgui_image_information)();
+		Cmgui_image_information_set_image_file_format(
+			cmgui_image_information, image_file_format);
+		Cmgui_image_information_add_file_name(cmgui_image_information,
+			view.file_name);
+		Cmgui_image_information_set_io_stream_package(cmgui_image_information,
+			command_data->io_stream_package);
+		struct Cmgui_image *cmgui_image = Graphics_window_get_image(view.window,
+			force_onscreen, width, height, antialias, transparency_layers, storage);
+		if (cmgui_image)
+		{
+			if (Cmgui_image_write(cmgui_image, cmgui_image_information))
+			{
+				++number_of_images;
+			}
+			else
+			{
+				display_message(ERROR_MESSAGE,
+					"gfx print:  Error writing image %s", view.file_name);
+				return_code = 0;
+			}
+			DESTROY(Cmgui_image)(&cmgui_image);
+		}
+		else
+		{
+			display_message(ERROR_MESSAGE,
+				"gfx print:  Could not get image %s from window", view.file_name);
+			return_code = 0;
+		}
+		DESTROY(Cmgui_image_information)(&cmgui_image_information);
+	}
+	for (w = 0; w < window_views.size(); ++w)
+	{
+		Gfx_print_window_view &window_view = window_views[w];
+		Graphics_window_end_print_batch(window_view.window);
+		struct Scene_viewer_app *scene_viewer =
+			Graphics_window_get_Scene_viewer(window_view.window, /*pane_no*/0);
+		cmzn_sceneviewer_begin_change(scene_viewer->core_scene_viewer);
+		cmzn_sceneviewer_set_lookat_parameters_non_skew(scene_viewer->core_scene_viewer,
+			window_view.eye, window_view.lookat, window_view.up);
+		cmzn_sceneviewer_set_view_angle(scene_viewer->core_scene_viewer, window_view.view_angle);
+		cmzn_sceneviewer_end_change(scene_viewer->core_scene_viewer);
+		DEACCESS(Graphics_window)(&window_view.window);
+	}
+	cmgui_gettimeofday(&end_time, (struct timezone *)NULL);
+	for (size_t v = 0; v < views.size(); ++v)
+	{
+		DEACCESS(Graphics_window)(&views[v].window);
+		DEALLOCATE(views[v].file_name);
+	}
+	const double elapsed_time = cmgui_get_elapsed_seconds(&start_time, &end_time);
+	display_message(INFORMATION_MESSAGE,
+		"gfx print:  Printed %d of %d views from %d windows in %g seconds\n",
+		static_cast<int>(number_of_images), static_cast<int>(views.size()),
+		static_cast<int>(window_views.size()), elapsed_time);
+	return return_code;
+}
+
 static int execute_command_gfx_print(struct Parse_state *state,
 	void *dummy_to_be_modified,void *command_data_void)
 /*******************************************************************************
@@ -11493,7 +12373,7 @@ DESCRIPTION :
 Executes a GFX PRINT command.
 ==============================================================================*/
 {
-	char *file_name, force_onscreen_flag;
+	char *file_name, force_onscreen_flag, *views_file_name;
 	const char*image_file_format_string, **valid_strings;
 	enum Image_file_format image_file_format;
 	enum Texture_storage_type storage;
@@ -11512,6 +12392,7 @@ Executes a GFX PRINT command.
 		/* initialize defaults */
 		antialias = -1;
 		file_name = (char *)NULL;
+		views_file_name = (char *)NULL;
 		height = 0;
 		force_onscreen_flag = 0;
 		storage = TEXTURE_RGBA;
@@ -11556,6 +12437,9 @@ Executes a GFX PRINT command.
 		/* transparency_layers */
 		Option_table_add_entry(option_table, "transparency_layers",
 			&transparency_layers, NULL, set_int_positive);
+		/* views */
+		Option_table_add_string_entry(option_table, "views", &views_file_name,
+			" VIEWS_FILE");
 		/* width */
 		Option_table_add_entry(option_table, "width",
 			&width, NULL, set_int_non_negative);
@@ -11568,7 +12452,7 @@ Executes a GFX PRINT command.
 		/* no errors, not asking for help */
 		if (return_code)
 		{
-			if (!file_name)
+			if ((!file_name) && (!views_file_name))
 			{
 				if (!(file_name = confirmation_get_write_filename(NULL,
 								 command_data->user_interface
@@ -11588,7 +12472,23 @@ Executes a GFX PRINT command.
 				return_code = 0;
 			}
 		}
-		if (return_code)
+		if (return_code && views_file_name)
+		{
+			if (image_file_format_string)
+			{
+				STRING_TO_ENUMERATOR(Image_file_format)(
+					image_file_format_string, &image_file_format);
+			}
+			if (file_name)
+			{
+				display_message(WARNING_MESSAGE,
+					"gfx print:  Ignoring file %s; image files are given in views", file_name);
+			}
+			return_code = gfx_print_views(views_file_name, window, command_data,
+				image_file_format, force_onscreen_flag, width, height, antialias,
+				transparency_layers, storage);
+		}
+		else if (return_code)
 		{
 			cmgui_image_information = CREATE(Cmgui_image_information)();
 			if (image_file_format_string)
@@ -11634,6 +12534,10 @@ Executes a GFX PRINT command.
 		{
 			DEALLOCATE(file_name);
 		}
+		if (views_file_name)
+		{
+			DEALLOCATE(views_file_name);
+		}
 	}
 	else
 	{
@@ -11737,6 +12641,242 @@ int offset_region_identifier(cmzn_region_id region, char element_flag, int eleme
 	return return_code;
 }
 
+/***************************************************************************//**
+ * Gets the names of the fields every new region has, so they can be told apart
+ * from fields created by the user or read from files.
+ */
+static void cmzn_region_get_default_field_names(cmzn_region_id region,
+	std::set<std::string> &field_names)
+{
+	cmzn_region_id new_region = cmzn_region_create_region(region);
+	cmzn_fieldmodule_id fieldmodule = cmzn_region_get_fieldmodule(new_region);
+	cmzn_fielditerator_id iterator = cmzn_fieldmodule_create_fielditerator(fieldmodule);
+	cmzn_field_id field;
+	while (0 != (field = cmzn_fielditerator_next(iterator)))
+	{
+		char *name = cmzn_field_get_name(field);
+		if (name)
+		{
+			field_names.insert(name);
+			DEALLOCATE(name);
+		}
+		cmzn_field_destroy(&field);
+	}
+	cmzn_fielditerator_destroy(&iterator);
+	cmzn_fieldmodule_destroy(&fieldmodule);
+	cmzn_region_destroy(&new_region);
+}
+
+/***************************************************************************//**
+ * Returns true if region has no subregions, nodes, data points or elements,
+ * and no fields other than those every new region has, so that reading a file
+ * straight into it gives the same result as reading into a separate region
+ * and merging.
+ */
+static bool cmzn_region_is_empty(cmzn_region_id region,
+	const std::set<std::string> &default_field_names)
+{
+	cmzn_region_id child_region = cmzn_region_get_first_child(region);
+	if (child_region)
+	{
+		cmzn_region_destroy(&child_region);
+		return false;
+	}
+	bool empty = true;
+	cmzn_fieldmodule_id fieldmodule = cmzn_region_get_fieldmodule(region);
+	for (int i = 0; empty && (i < 2); ++i)
+	{
+		cmzn_nodeset_id nodeset = cmzn_fieldmodule_find_nodeset_by_field_domain_type(fieldmodule,
+			(0 == i) ? CMZN_FIELD_DOMAIN_TYPE_NODES : CMZN_FIELD_DOMAIN_TYPE_DATAPOINTS);
+		if (0 < cmzn_nodeset_get_size(nodeset))
+			empty = false;
+		cmzn_nodeset_destroy(&nodeset);
+	}
+	for (int dimension = 1; empty && (dimension <= 3); ++dimension)
+	{
+		cmzn_mesh_id mesh = cmzn_fieldmodule_find_mesh_by_dimension(fieldmodule, dimension);
+		if (0 < cmzn_mesh_get_size(mesh))
+			empty = false;
+		cmzn_mesh_destroy(&mesh);
+	}
+	if (empty)
+	{
+		cmzn_fielditerator_id iterator = cmzn_fieldmodule_create_fielditerator(fieldmodule);
+		cmzn_field_id field;
+		while (empty && (0 != (field = cmzn_fielditerator_next(iterator))))
+		{
+			char *name = cmzn_field_get_name(field);
+			if ((!name) || (default_field_names.find(name) == default_field_names.end()))
+				empty = false;
+			DEALLOCATE(name);
+			cmzn_field_destroy(&field);
+		}
+		cmzn_fielditerator_destroy(&iterator);
+	}
+	cmzn_fieldmodule_destroy(&fieldmodule);
+	return empty;
+}
+
+/***************************************************************************//**
+ * Returns a region found empty by cmzn_region_is_empty to that state after a
+ * failed read into it, removing subregions, elements, nodes, data points and
+ * all but the default fields.
+ */
+static void cmzn_region_clear(cmzn_region_id region,
+	const std::set<std::string> &default_field_names)
+{
+	cmzn_region_begin_hierarchical_change(region);
+	cmzn_region_id child_region;
+	while (0 != (child_region = cmzn_region_get_first_child(region)))
+	{
+		cmzn_region_remove_child(region, child_region);
+		cmzn_region_destroy(&child_region);
+	}
+	cmzn_fieldmodule_id fieldmodule = cmzn_region_get_fieldmodule(region);
+	for (int dimension = 3; 0 < dimension; --dimension)
+	{
+		cmzn_mesh_id mesh = cmzn_fieldmodule_find_mesh_by_dimension(fieldmodule, dimension);
+		cmzn_mesh_destroy_all_elements(mesh);
+		cmzn_mesh_destroy(&mesh);
+	}
+	for (int i = 0; i < 2; ++i)
+	{
+		cmzn_nodeset_id nodeset = cmzn_fieldmodule_find_nodeset_by_field_domain_type(fieldmodule,
+			(0 == i) ? CMZN_FIELD_DOMAIN_TYPE_NODES : CMZN_FIELD_DOMAIN_TYPE_DATAPOINTS);
+		cmzn_nodeset_destroy_all_nodes(nodeset);
+		cmzn_nodeset_destroy(&nodeset);
+	}
+	cmzn_fielditerator_id iterator = cmzn_fieldmodule_create_fielditerator(fieldmodule);
+	cmzn_field_id field;
+	while (0 != (field = cmzn_fielditerator_next(iterator)))
+	{
+		char *name = cmzn_field_get_name(field);
+		if ((!name) || (default_field_names.find(name) == default_field_names.end()))
+			cmzn_field_set_managed(field, false);
+		DEALLOCATE(name);
+		cmzn_field_destroy(&field);
+	}
+	cmzn_fielditerator_destroy(&iterator);
+	cmzn_fieldmodule_destroy(&fieldmodule);
+	cmzn_region_end_hierarchical_change(region);
+}
+
+/***************************************************************************//**
+ * Reads input_file into top_region directly if direct is set, otherwise into
+ * a separate region which is merged into top_region, applying offsets.
+ * Adds the time taken by each stage to the supplied times.
+ */
+static int gfx_read_region_file_into(cmzn_region_id top_region, bool direct,
+	struct IO_stream *input_file, struct FE_import_time_index *time_index,
+	int use_data, char element_flag, int element_offset, char face_flag,
+	int face_offset, char line_flag, int line_offset, char node_flag,
+	int node_offset, const char *file_name, const char *file_type,
+	double *read_time, double *offset_time, double *merge_time)
+{
+	int return_code = 1;
+	struct timeval start_time;
+	const bool offsets = (element_flag || face_flag || line_flag || node_flag);
+	cmzn_region_id region = direct ? cmzn_region_access(top_region) :
+		cmzn_region_create_region(top_region);
+	if (direct)
+		cmzn_region_begin_hierarchical_change(top_region);
+	cmgui_gettimeofday(&start_time, (struct timezone *)NULL);
+	if (use_data)
+		return_code = read_exdata_file(region, input_file, time_index);
+	else
+		return_code = read_exregion_file(region, input_file, time_index);
+	*read_time += cmgui_get_elapsed_seconds(&start_time, /*end_time*/NULL);
+	if (return_code)
+	{
+		if (offsets)
+		{
+			cmgui_gettimeofday(&start_time, (struct timezone *)NULL);
+			return_code = offset_region_identifier(region, element_flag, element_offset, face_flag,
+				face_offset, line_flag, line_offset, node_flag, node_offset, use_data);
+			*offset_time += cmgui_get_elapsed_seconds(&start_time, /*end_time*/NULL);
+		}
+		if (return_code && !direct)
+		{
+			cmgui_gettimeofday(&start_time, (struct timezone *)NULL);
+			if (cmzn_region_can_merge(top_region, region))
+			{
+				if (!cmzn_region_merge(top_region, region))
+				{
+					display_message(ERROR_MESSAGE, "Error merging %s%s from file: %s",
+						use_data ? "data" : file_type, use_data ? "" : "s", file_name);
+					return_code = 0;
+				}
+			}
+			else
+			{
+				display_message(ERROR_MESSAGE,
+					"Contents of file %s not compatible with global objects",
+					file_name);
+				return_code = 0;
+			}
+			*merge_time += cmgui_get_elapsed_seconds(&start_time, /*end_time*/NULL);
+		}
+	}
+	else
+	{
+		display_message(ERROR_MESSAGE,
+			"Error reading %s file: %s", file_type, file_name);
+	}
+	if (direct)
+		cmzn_region_end_hierarchical_change(top_region);
+	cmzn_region_destroy(&region);
+	return return_code;
+}
+
+/***************************************************************************//**
+ * Reads an exregion file, or exdata file if use_data is set, into top_region,
+ * applying any identifier offsets.
+ * If top_region is empty the file is read directly into it and offsets are
+ * applied in place, avoiding a second copy of its contents and the merge pass.
+ * If that fails, the region is emptied again, so a failed read leaves
+ * top_region unchanged without reading the file a second time. Otherwise the file
+ * is read into a separate region which is offset, checked for compatibility
+ * and merged into top_region.
+ * If timing_flag is set, reports the time taken by each stage and on Unix the
+ * peak memory use of the process.
+ *
+ * @param file_type  Name of file type for messages: "element" or "node".
+ */
+static int gfx_read_region_file(cmzn_region_id top_region,
+	struct IO_stream *input_file, struct FE_import_time_index *time_index,
+	int use_data, char element_flag, int element_offset, char face_flag,
+	int face_offset, char line_flag, int line_offset, char node_flag,
+	int node_offset, const char *file_name, const char *file_type,
+	char timing_flag)
+{
+	double read_time = 0.0, offset_time = 0.0, merge_time = 0.0;
+	std::set<std::string> default_field_names;
+	cmzn_region_get_default_field_names(top_region, default_field_names);
+	bool direct = cmzn_region_is_empty(top_region, default_field_names);
+	int return_code = gfx_read_region_file_into(top_region, direct, input_file,
+		time_index, use_data, element_flag, element_offset, face_flag, face_offset,
+		line_flag, line_offset, node_flag, node_offset, file_name, file_type,
+		&read_time, &offset_time, &merge_time);
+	if ((!return_code) && direct)
+	{
+		/* leave top_region empty as it was before the failed read */
+		cmzn_region_clear(top_region, default_field_names);
+	}
+	if (timing_flag)
+	{
+		display_message(INFORMATION_MESSAGE, "Read %s %s: read %g s, offset %g s, merge %g s\n",
+			file_name, direct ? "directly" : "via merge", read_time, offset_time, merge_time);
+#if !defined (WIN32_SYSTEM)
+		struct rusage usage;
+		if (0 == getrusage(RUSAGE_SELF, &usage))
+		{
+			display_message(INFORMATION_MESSAGE, "  peak memory %ld kB\n", (long)usage.ru_maxrss);
+		}
+#endif /* !defined (WIN32_SYSTEM) */
+	}
+	return return_code;
+}
+
 static int gfx_read_elements(struct Parse_state *state,
 	void *dummy_to_be_modified,void *command_data_void)
 /*******************************************************************************
@@ -11748,11 +12888,11 @@ user, otherwise the elements file is read.
 ==============================================================================*/
 {
 	char *file_name, *region_path,
-		element_flag, face_flag, line_flag, node_flag;
+		element_flag, face_flag, line_flag, node_flag, timing_flag;
 	int element_offset, face_offset, line_offset, node_offset,
 		return_code;
 	struct cmzn_command_data *command_data;
-	struct cmzn_region *region, *top_region;
+	struct cmzn_region *top_region;
 	struct IO_stream *input_file;
 	struct Option_table *option_table;
 
@@ -11769,6 +12909,7 @@ user, otherwise the elements file is read.
 		line_offset = 0;
 		node_flag = 0;
 		node_offset = 0;
+		timing_flag = 0;
 		file_name = (char *)NULL;
 		region_path = (char *)NULL;
 		option_table = CREATE(Option_table)();
@@ -11790,6 +12931,8 @@ user, otherwise the elements file is read.
 		/* region */
 		Option_table_add_entry(option_table,"region",
 			&region_path, (void *)1, set_name);
+		/* timing */
+		Option_table_add_char_flag_entry(option_table, "timing", &timing_flag);
 		/* default */
 		Option_table_add_entry(option_table,NULL,&file_name,
 			NULL,set_file_name);
@@ -11849,42 +12992,11 @@ user, otherwise the elements file is read.
 				if ((input_file = CREATE(IO_stream)(command_data->io_stream_package))
 					&& (IO_stream_open_for_read(input_file, file_name)))
 				{
-					region = cmzn_region_create_region(top_region);
-					if (read_exregion_file(region, input_file,
-						(struct FE_import_time_index *)NULL))
-					{
-						if (element_flag || face_flag || line_flag || node_flag)
-						{
-							return_code = offset_region_identifier(region, element_flag, element_offset, face_flag,
-								face_offset, line_flag, line_offset, node_flag, node_offset, /*use_data*/0);
-						}
-						if (return_code)
-						{
-							if (cmzn_region_can_merge(top_region, region))
-							{
-								if (!cmzn_region_merge(top_region, region))
-								{
-									display_message(ERROR_MESSAGE,
-										"Error merging elements from file: %s", file_name);
-									return_code = 0;
-								}
-							}
-							else
-							{
-								display_message(ERROR_MESSAGE,
-									"Contents of file %s not compatible with global objects",
-									file_name);
-								return_code = 0;
-							}
-						}
-					}
-					else
-					{
-						display_message(ERROR_MESSAGE,
-							"Error reading element file: %s", file_name);
-						return_code = 0;
-					}
-					DEACCESS(cmzn_region)(&region);
+					return_code = gfx_read_region_file(top_region, input_file,
+						(struct FE_import_time_index *)NULL, /*use_data*/0,
+						element_flag, element_offset, face_flag, face_offset,
+						line_flag, line_offset, node_flag, node_offset,
+						file_name, "element", timing_flag);
 					IO_stream_close(input_file);
 					DESTROY(IO_stream)(&input_file);
 				}
@@ -11932,12 +13044,12 @@ otherwise the nodes file is read.
 If the <use_data> flag is set, then read data, otherwise nodes.
 ==============================================================================*/
 {
-	char *file_name, node_offset_flag, *region_path, time_set_flag;
+	char *file_name, node_offset_flag, *region_path, time_set_flag, timing_flag;
 	double maximum, minimum;
 	float time;
 	int node_offset, return_code;
 	struct cmzn_command_data *command_data;
-	struct cmzn_region *region, *top_region;
+	struct cmzn_region *top_region;
 	struct FE_import_time_index *node_time_index, node_time_index_data;
 	struct IO_stream *input_file;
 	struct Option_table *option_table;
@@ -11954,6 +13066,7 @@ If the <use_data> flag is set, then read data, otherwise nodes.
 			region_path = (char *)NULL;
 			time = 0;
 			time_set_flag = 0;
+			timing_flag = 0;
 			node_time_index = (struct FE_import_time_index *)NULL;
 			option_table=CREATE(Option_table)();
 			/* example */
@@ -11976,6 +13089,8 @@ If the <use_data> flag is set, then read data, otherwise nodes.
 			/* time */
 			Option_table_add_entry(option_table,"time",
 				&time, &time_set_flag, set_float_and_char_flag);
+			/* timing */
+			Option_table_add_char_flag_entry(option_table, "timing", &timing_flag);
 			/* default */
 			Option_table_add_entry(option_table, NULL, &file_name,
 				NULL, set_file_name);
@@ -12057,63 +13172,10 @@ If the <use_data> flag is set, then read data, otherwise nodes.
 						if ((input_file = CREATE(IO_stream)(command_data->io_stream_package))
 							&& (IO_stream_open_for_read(input_file, file_name)))
 						{
-							region = cmzn_region_create_region(top_region);
-							if (use_data)
-							{
-								return_code = read_exdata_file(region, input_file, node_time_index);
-							}
-							else
-							{
-								return_code = read_exregion_file(region, input_file, node_time_index);
-							}
-							if (return_code)
-							{
-								if (node_offset_flag)
-								{
-									/* Offset these nodes before merging */
-									if (use_data)
-									{
-										return_code = offset_region_identifier(region, 0, 0, 0,
-											0, 0, 0, node_offset_flag, node_offset, /*use_data*/1);
-									}
-									else
-									{
-										return_code = offset_region_identifier(region, 0, 0, 0,
-											0, 0, 0, node_offset_flag, node_offset, /*use_data*/0);
-									}
-								}
-								if (cmzn_region_can_merge(top_region, region))
-								{
-									if (!cmzn_region_merge(top_region, region))
-									{
-										if (use_data)
-										{
-											display_message(ERROR_MESSAGE,
-												"Error merging data from file: %s", file_name);
-										}
-										else
-										{
-											display_message(ERROR_MESSAGE,
-												"Error merging nodes from file: %s", file_name);
-										}
-										return_code = 0;
-									}
-								}
-								else
-								{
-									display_message(ERROR_MESSAGE,
-										"Contents of file %s not compatible with global objects",
-										file_name);
-									return_code = 0;
-								}
-							}
-							else
-							{
-								display_message(ERROR_MESSAGE,
-									"Error reading node file: %s", file_name);
-								return_code = 0;
-							}
-							DEACCESS(cmzn_region)(&region);
+							return_code = gfx_read_region_file(top_region, input_file,
+								node_time_index, (use_data != 0), /*element_flag*/0, 0,
+								/*face_flag*/0, 0, /*line_flag*/0, 0, node_offset_flag, node_offset,
+								file_name, "node", timing_flag);
 							IO_stream_close(input_file);
 							DESTROY(IO_stream)(&input_file);
 							input_file =NULL;
@@ -12325,9 +13387,43 @@ static int gfx_read_region(struct Parse_state *state,
 	return return_code;
 }
 
+/* largest field width allowed in a series file name pattern */
+#define WAVEFRONT_OBJ_SERIES_MAXIMUM_FIELD_WIDTH 20
+
+/**
+ * Checks pattern contains exactly one integer conversion of the form %d or
+ * %0Nd, with N at most WAVEFRONT_OBJ_SERIES_MAXIMUM_FIELD_WIDTH, and no other
+ * % characters, so it can be used to name series files.
+ */
+static int wavefront_obj_series_pattern_is_valid(const char *pattern)
+{
+	int number_of_conversions = 0;
+	for (const char *c = pattern; *c; ++c)
+	{
+		if (*c == '%')
+		{
+			++c;
+			int field_width = 0;
+			while (isdigit((unsigned char)*c))
+			{
+				field_width = field_width*10 + (*c - '0');
+				if (field_width > WAVEFRONT_OBJ_SERIES_MAXIMUM_FIELD_WIDTH)
+					return 0;
+				++c;
+			}
+			if (*c != 'd')
+				return 0;
+			++number_of_conversions;
+		}
+	}
+	return (1 == number_of_conversions);
+}
+
 /**
  * If a file is not specified a file selection box is presented to the user,
- * otherwise the wavefront obj file is read.
+ * otherwise the wavefront obj file is read. With the series option, files
+ * numbered from first to last are read as successive times of the same
+ * graphics object.
  */
 static int gfx_read_wavefront_obj(struct Parse_state *state,
 	void *dummy_to_be_modified,void *command_data_void)
@@ -12335,8 +13431,9 @@ static int gfx_read_wavefront_obj(struct Parse_state *state,
 	char *file_name, *graphics_object_name,	*specified_graphics_object_name;
 	const char *render_polygon_mode_string, **valid_strings;
 	enum cmzn_graphics_render_polygon_mode render_polygon_mode;
-	float time;
-	int number_of_valid_strings, return_code;
+	char series_flag, timing_flag;
+	float time, time_step;
+	int first, last, number_of_valid_strings, return_code;
 	struct cmzn_command_data *command_data;
 	struct Option_table *option_table;
 
@@ -12349,15 +13446,30 @@ static int gfx_read_wavefront_obj(struct Parse_state *state,
 			specified_graphics_object_name=(char *)NULL;
 			graphics_object_name=(char *)NULL;
 			time = 0;
+			time_step = 1.0;
+			first = 0;
+			last = 0;
+			series_flag = 0;
+			timing_flag = 0;
 			file_name=(char *)NULL;
 
 			option_table=CREATE(Option_table)();
+			Option_table_add_help(option_table,
+				"Read a Wavefront OBJ surface into a graphics object at 'time'. With "
+				"'series' the file name must contain one integer conversion such as %04d "
+				"and files numbered from 'first' to 'last' are read into the same "
+				"graphics object, file number N at time + (N - first)*time_step. "
+				"'timing' reports the number of files and time taken.");
+			/* first */
+			Option_table_add_int_non_negative_entry(option_table,"first",&first);
 			/* example */
 			Option_table_add_entry(option_table,CMGUI_EXAMPLE_DIRECTORY_SYMBOL,
 			  &file_name, &(command_data->example_directory), set_file_name);
 			/* as */
 			Option_table_add_entry(option_table,"as",&specified_graphics_object_name,
 				(void *)1,set_name);
+			/* last */
+			Option_table_add_int_non_negative_entry(option_table,"last",&last);
 			/* render_polygon_mode */
 			render_polygon_mode = CMZN_GRAPHICS_RENDER_POLYGON_MODE_SHADED;
 			render_polygon_mode_string = ENUMERATOR_STRING(cmzn_graphics_render_polygon_mode)(render_polygon_mode);
@@ -12367,8 +13479,14 @@ static int gfx_read_wavefront_obj(struct Parse_state *state,
 			Option_table_add_enumerator(option_table,number_of_valid_strings,
 				valid_strings,&render_polygon_mode_string);
 			DEALLOCATE(valid_strings);
+			/* series */
+			Option_table_add_char_flag_entry(option_table,"series",&series_flag);
 			/* time */
 			Option_table_add_entry(option_table,"time",&time,NULL,set_float);
+			/* time_step */
+			Option_table_add_entry(option_table,"time_step",&time_step,NULL,set_float);
+			/* timing */
+			Option_table_add_char_flag_entry(option_table,"timing",&timing_flag);
 			/* default */
 			Option_table_add_entry(option_table,NULL,&file_name,
 				NULL,set_file_name);
@@ -12390,6 +13508,29 @@ static int gfx_read_wavefront_obj(struct Parse_state *state,
 						return_code = 0;
 					}
 				}
+				if (return_code && series_flag)
+				{
+					if (!wavefront_obj_series_pattern_is_valid(file_name))
+					{
+						display_message(ERROR_MESSAGE,
+							"gfx read wavefront_obj:  Series file name must contain one integer "
+							"conversion such as %%04d, with field width at most %d, and no other "
+							"%% characters", WAVEFRONT_OBJ_SERIES_MAXIMUM_FIELD_WIDTH);
+						return_code = 0;
+					}
+					else if (last < first)
+					{
+						display_message(ERROR_MESSAGE,
+							"gfx read wavefront_obj:  Series last must not be less than first");
+						return_code = 0;
+					}
+					else if (!specified_graphics_object_name)
+					{
+						display_message(ERROR_MESSAGE,
+							"gfx read wavefront_obj:  Series requires a graphics object name 'as'");
+						return_code = 0;
+					}
+				}
 				if (return_code)
 				{
 					if(specified_graphics_object_name)
@@ -12400,8 +13541,60 @@ static int gfx_read_wavefront_obj(struct Parse_state *state,
 					{
 						graphics_object_name = file_name;
 					}
+					struct timeval start_time, end_time;
+					cmgui_gettimeofday(&start_time, (struct timezone *)NULL);
+					int number_of_files = 0;
+					if (series_flag)
+					{
+						/* room for the widest field and any int */
+						const size_t series_file_name_size = strlen(file_name) +
+							WAVEFRONT_OBJ_SERIES_MAXIMUM_FIELD_WIDTH + 16;
+						char *series_file_name;
+						if (ALLOCATE(series_file_name, char, series_file_name_size))
+						{
+							for (int index = first; (index <= last) && return_code; ++index)
+							{
+								const int length = snprintf(series_file_name,
+									series_file_name_size, file_name, index);
+								if ((length < 0) || (static_cast<size_t>(length) >= series_file_name_size))
+								{
+									display_message(ERROR_MESSAGE,
+										"gfx read wavefront_obj:  Series file name for index %d is too long",
+										index);
+									return_code = 0;
+									break;
+								}
+								char *index_file_name = duplicate_string(series_file_name);
+								if (0 != (return_code = check_suffix(&index_file_name, ".obj")))
+								{
+									return_code = file_read_surface_graphics_object_from_obj(
+										index_file_name, command_data->io_stream_package,
+										graphics_object_name, render_polygon_mode,
+										time + (float)(index - first)*time_step,
+										command_data->materialmodule,
+										command_data->glyphmodule);
+									if (return_code)
+									{
+										++number_of_files;
+									}
+									else
+									{
+										display_message(ERROR_MESSAGE,
+											"gfx read wavefront_obj:  Could not read series file %s",
+											index_file_name);
+									}
+								}
+								DEALLOCATE(index_file_name);
+							}
+							DEALLOCATE(series_file_name);
+						}
+						else
+						{
+							return_code = 0;
+						}
+					}
 					/* open the file */
-					if (0 != (return_code = check_suffix(&file_name, ".obj")))
+					else if (0 != (return_code = check_suffix(&file_name, ".obj")))
 					{
 
 						return_code=file_read_surface_graphics_object_from_obj(file_name,
@@ -12409,6 +13602,17 @@ static int gfx_read_wavefront_obj(struct Parse_state *state,
 							graphics_object_name, render_polygon_mode, time,
 							command_data->materialmodule,
 							command_data->glyphmodule);
+						if (return_code)
+						{
+							number_of_files = 1;
+						}
+					}
+					if (timing_flag)
+					{
+						cmgui_gettimeofday(&end_time, (struct timezone *)NULL);
+						display_message(INFORMATION_MESSAGE,
+							"gfx read wavefront_obj:  Read %d files in %g seconds\n",
+							number_of_files, cmgui_get_elapsed_seconds(&start_time, &end_time));
 					}
 				}
 			}
@@ -12774,6 +13978,175 @@ static int execute_command_gfx_select(struct Parse_state *state,
 	return (return_code);
 }
 
+/***************************************************************************//**
+ * Enables, disables or clears the on-disk cache of images evaluated from image
+ * filter fields by gfx modify texture evaluate_image.
+ */
+static int gfx_set_image_filter_cache(struct Parse_state *state,
+	void *dummy_to_be_modified, void *dummy_user_data)
+{
+	int return_code = 0;
+
+	ENTER(gfx_set_image_filter_cache);
+	USE_PARAMETER(dummy_to_be_modified);
+	USE_PARAMETER(dummy_user_data);
+	if (state)
+	{
+		char clear_flag = 0;
+		char *directory = NULL;
+		double maximum_megabytes = 1024.0;
+		char off_flag = 0;
+		Option_table *option_table = CREATE(Option_table)();
+		Option_table_add_help(option_table,
+			"Cache images evaluated from fields at their native resolution, eg. "
+			"the output of image filters, in an existing 'directory' and reuse "
+			"them when the same fields, source images and evaluate_image options "
+			"are evaluated again, including in later sessions. Least recently "
+			"used images are removed once the cache exceeds 'maximum_megabytes'. "
+			"Only images evaluated from image fields through image filter fields "
+			"are cached. 'off' disables the cache. Use "
+			"'gfx list image_filter_cache' to see hit and miss counts.");
+		Option_table_add_char_flag_entry(option_table, "clear", &clear_flag);
+		Option_table_add_string_entry(option_table, "directory",
+			&directory, " DIRECTORY_NAME");
+		Option_table_add_positive_double_entry(option_table, "maximum_megabytes",
+			&maximum_megabytes);
+		Option_table_add_char_flag_entry(option_table, "off", &off_flag);
+		return_code = Option_table_multi_parse(option_table, state);
+		DESTROY(Option_table)(&option_table);
+		if (return_code)
+		{
+			if (directory && off_flag)
+			{
+				display_message(ERROR_MESSAGE,
+					"gfx set image_filter_cache:  Specify only one of directory or off");
+				return_code = 0;
+			}
+			else
+			{
+				if (clear_flag)
+					return_code = Image_filter_cache_clear();
+				if (return_code && (directory || off_flag))
+					return_code = Image_filter_cache_set_directory(directory, maximum_megabytes);
+			}
+		}
+		DEALLOCATE(directory);
+	}
+	else
+	{
+		display_message(ERROR_MESSAGE,
+			"gfx_set_image_filter_cache.  Invalid argument(s)");
+	}
+	LEAVE;
+
+	return (return_code);
+}
+
+/***************************************************************************//**
+ * Sets the number of threads used by all ITK image filters.
+ */
+static int gfx_set_image_filter_threads(struct Parse_state *state,
+	void *dummy_to_be_modified, void *root_region_void)
+{
+	int return_code = 0;
+
+	ENTER(gfx_set_image_filter_threads);
+	USE_PARAMETER(dummy_to_be_modified);
+	cmzn_region_id root_region = static_cast<cmzn_region_id>(root_region_void);
+	if (state && root_region)
+	{
+		int number_of_threads = Image_filter_get_number_of_threads();
+		Option_table *option_table = CREATE(Option_table)();
+		Option_table_add_help(option_table,
+			"Set the number of threads used by all ITK image filters. ITK reads it "
+			"when the first image filter is evaluated, so it can only be set before "
+			"any image filter fields are defined. Use 'gfx list image_filter_threads' "
+			"to see the current value.");
+		Option_table_add_entry(option_table, (const char *)NULL, &number_of_threads,
+			NULL, set_int_positive);
+		return_code = Option_table_multi_parse(option_table, state);
+		DESTROY(Option_table)(&option_table);
+		if (return_code)
+		{
+			if (0 < number_of_threads)
+			{
+				return_code = Image_filter_set_number_of_threads(number_of_threads, root_region);
+			}
+			else
+			{
+				display_message(ERROR_MESSAGE,
+					"gfx set image_filter_threads:  Missing number of threads");
+				return_code = 0;
+			}
+		}
+	}
+	else
+	{
+		display_message(ERROR_MESSAGE,
+			"gfx_set_image_filter_threads.  Invalid argument(s)");
+	}
+	LEAVE;
+
+	return (return_code);
+}
+
+/***************************************************************************//**
+ * Enables, disables or clears the cache of regions and groups found from
+ * paths in commands.
+ */
+static int gfx_set_region_path_cache(struct Parse_state *state,
+	void *dummy_to_be_modified, void *region_path_cache_void)
+{
+	int return_code = 0;
+	struct Region_path_cache *region_path_cache;
+
+	ENTER(gfx_set_region_path_cache);
+	USE_PARAMETER(dummy_to_be_modified);
+	if (state && (region_path_cache = static_cast<struct Region_path_cache *>(region_path_cache_void)))
+	{
+		char clear_flag = 0;
+		char off_flag = 0;
+		char on_flag = 0;
+		Option_table *option_table = CREATE(Option_table)();
+		Option_table_add_help(option_table,
+			"Cache the regions and groups found from paths in commands so repeated "
+			"paths are not resolved again. The cache is 'on' by default and is "
+			"cleared automatically when regions on cached paths are added, "
+			"removed or renamed, or fields in them are removed or renamed. "
+			"'clear' empties it and 'off' disables it. Use "
+			"'gfx list region_path_cache' to see hit and miss counts.");
+		Option_table_add_char_flag_entry(option_table, "clear", &clear_flag);
+		Option_table_add_char_flag_entry(option_table, "off", &off_flag);
+		Option_table_add_char_flag_entry(option_table, "on", &on_flag);
+		return_code = Option_table_multi_parse(option_table, state);
+		DESTROY(Option_table)(&option_table);
+		if (return_code)
+		{
+			if (on_flag && off_flag)
+			{
+				display_message(ERROR_MESSAGE,
+					"gfx set region_path_cache:  Specify only one of on or off");
+				return_code = 0;
+			}
+			else
+			{
+				if (clear_flag)
+					Region_path_cache_clear(region_path_cache);
+				if (on_flag || off_flag)
+					Region_path_cache_set_enabled(region_path_cache, on_flag);
+			}
+		}
+	}
+	else
+	{
+		display_message(ERROR_MESSAGE,
+			"gfx_set_region_path_cache.  Invalid argument(s)");
+	}
+	LEAVE;
+
+	return (return_code);
+}
+
 /***************************************************************************//**
  * Sets the order of regions in the region hierarchy.
  */
@@ -13134,6 +14507,80 @@ static int gfx_set_transformation(struct Parse_state *state,
 	return (return_code);
 } /* gfx_set_transformation */
 
+/***************************************************************************//**
+ * Reads or clears the table of scene transformations over time applied
+ * whenever the default timekeeper time changes.
+ */
+static int gfx_set_transformation_table(struct Parse_state *state,
+	void *dummy_to_be_modified, void *command_data_void)
+{
+	int return_code = 0;
+
+	ENTER(gfx_set_transformation_table);
+	USE_PARAMETER(dummy_to_be_modified);
+	struct cmzn_command_data *command_data = (struct cmzn_command_data *)command_data_void;
+	if (state && command_data)
+	{
+		char clear_flag = 0;
+		char *file_name = NULL;
+		Option_table *option_table = CREATE(Option_table)();
+		Option_table_add_help(option_table,
+			"Read transformations of many region scenes over time from a 'file' "
+			"with lines 'REGION_PATH, TIME, 16 matrix values' in the column major "
+			"order used by gfx set transformation, or from the equivalent binary "
+			"file. Whenever the timekeeper time changes, each scene is given its "
+			"matrix at the latest time not after it, in a single change. Reading "
+			"a file replaces the previous table; 'clear' removes it, leaving "
+			"scenes with their current transformations. Use "
+			"'gfx list transformation_table' to see its size and update times.");
+		Option_table_add_char_flag_entry(option_table, "clear", &clear_flag);
+		Option_table_add_string_entry(option_table, "file",
+			&file_name, " FILE_NAME");
+		return_code = Option_table_multi_parse(option_table, state);
+		DESTROY(Option_table)(&option_table);
+		if (return_code)
+		{
+			if (!command_data->scene_transformation_table)
+			{
+				display_message(ERROR_MESSAGE,
+					"gfx set transformation_table:  Requires a timekeeper");
+				return_code = 0;
+			}
+			else if (clear_flag && file_name)
+			{
+				display_message(ERROR_MESSAGE,
+					"gfx set transformation_table:  Specify only one of clear or file");
+				return_code = 0;
+			}
+			else if (clear_flag)
+			{
+				return_code = Scene_transformation_table_clear(
+					command_data->scene_transformation_table);
+			}
+			else if (file_name)
+			{
+				return_code = Scene_transformation_table_read_file(
+					command_data->scene_transformation_table, file_name);
+			}
+			else
+			{
+				display_message(ERROR_MESSAGE,
+					"gfx set transformation_table:  Must specify clear or file");
+				return_code = 0;
+			}
+		}
+		DEALLOCATE(file_name);
+	}
+	else
+	{
+		display_message(ERROR_MESSAGE,
+			"gfx_set_transformation_table.  Invalid argument(s)");
+	}
+	LEAVE;
+
+	return (return_code);
+}
+
 /***************************************************************************//**
  * Toggles the visibility of graphics objects on scenes from the command line.
  */
@@ -13255,12 +14702,20 @@ Executes a GFX SET command.
 		{
 			double point_size = 0.0;
 			option_table=CREATE(Option_table)();
+			Option_table_add_entry(option_table, "image_filter_cache", NULL,
+				NULL, gfx_set_image_filter_cache);
+			Option_table_add_entry(option_table, "image_filter_threads", NULL,
+				(void *)command_data->root_region, gfx_set_image_filter_threads);
 			Option_table_add_entry(option_table, "order", NULL,
 				(void *)command_data->root_region, gfx_set_region_order);
+			Option_table_add_entry(option_table, "region_path_cache", NULL,
+				(void *)command_data->region_path_cache, gfx_set_region_path_cache);
 			Option_table_add_positive_double_entry(option_table, "point_size",
 				&point_size);
 			Option_table_add_entry(option_table, "transformation", NULL,
 				command_data_void, gfx_set_transformation);
+			Option_table_add_entry(option_table, "transformation_table", NULL,
+				command_data_void, gfx_set_transformation_table);
 #if defined (WX_USER_INTERFACE)
 			Option_table_add_entry(option_table, "time", NULL,
 				command_data_void, gfx_set_time);
@@ -13379,7 +14834,7 @@ DESCRIPTION :
 ==============================================================================*/
 {
 	char every, loop, maximum_flag, minimum_flag, once, play, set_time_flag,
-		skip, speed_flag, stop, swing;
+		skip, speed_flag, statistics, stop, swing;
 	double maximum, minimum, set_time, speed;
 	int return_code;
 	static struct Modifier_entry option_table[]=
@@ -13393,6 +14848,7 @@ DESCRIPTION :
 		{"set_time",NULL,NULL,set_double_and_char_flag},
 		{"skip_frames",NULL,NULL,set_char_flag},
 		{"speed",NULL,NULL,set_double_and_char_flag},
+		{"statistics",NULL,NULL,set_char_flag},
 		{"stop",NULL,NULL,set_char_flag},
 		{"swing",NULL,NULL,set_char_flag},
 		{NULL,NULL,NULL,NULL}
@@ -13463,6 +14919,7 @@ DESCRIPTION :
 				set_time_flag = 0;
 				skip = 0;
 				speed_flag = 0;
+				statistics = 0;
 				stop = 0;
 				swing = 0;
 
@@ -13479,8 +14936,9 @@ DESCRIPTION :
 				(option_table[7]).to_be_modified = &skip;
 				(option_table[8]).to_be_modified = &speed;
 				(option_table[8]).user_data = &speed_flag;
-				(option_table[9]).to_be_modified = &stop;
-				(option_table[10]).to_be_modified = &swing;
+				(option_table[9]).to_be_modified = &statistics;
+				(option_table[10]).to_be_modified = &stop;
+				(option_table[11]).to_be_modified = &swing;
 				return_code=process_multiple_options(state,option_table);
 
 				if(return_code)
@@ -13552,6 +15010,10 @@ DESCRIPTION :
 						{
 							time_keeper_app->stop();
 						}
+						if ( statistics )
+						{
+							time_keeper_app->listPlaybackStatistics();
+						}
 #if defined (WX_USER_INTERFACE)
 						if (command_data->graphics_window_manager)
 						{
@@ -14840,7 +16302,7 @@ Executes a GFX command.
 			Option_table_add_entry(option_table, "list", NULL,
 				command_data_void, execute_command_gfx_list);
 			Option_table_add_entry(option_table, "minimise",
-				NULL, (void *)command_data->root_region, gfx_minimise);
+				NULL, (void *)command_data->minimise_package, gfx_minimise);
 			Option_table_add_entry(option_table, "modify", NULL,
 				command_data_void, execute_command_gfx_modify);
 #if defined (SGI_MOVIE_FILE)
@@ -15470,50 +16932,115 @@ Executes a SET command.
 } /* execute_command_set */
 
 static int execute_command_system(struct Parse_state *state,
-	void *dummy_to_be_modified,void *dummy_user_data)
+	void *dummy_to_be_modified,void *command_data_void)
 /*******************************************************************************
 LAST MODIFIED : 19 February 1998
 
 DESCRIPTION :
-Executes a SET DIR #CMGUI_EXAMPLE_DIRECTORY_SYMBOL command.
-???RC Obsolete?
+Executes a SYSTEM command, running the rest of the command string with the
+shell. With the background token the command is run without blocking and a job
+id is returned; wait [JOB] waits for one or all background jobs and jobs lists
+them.
 ==============================================================================*/
 {
-	char *command, *system_command;
+	const char *command;
+	char *system_command;
 	const char *current_token;
 	int return_code;
+	struct cmzn_command_data *command_data;
 
 	ENTER(execute_command_system);
 	USE_PARAMETER(dummy_to_be_modified);
-	USE_PARAMETER(dummy_user_data);
 	return_code=0;
 	/* check argument */
-	if (state)
+	if (state && (command_data = (struct cmzn_command_data *)command_data_void))
 	{
 		if (NULL != (current_token = state->current_token))
 		{
 			if (strcmp(PARSER_HELP_STRING,current_token)&&
 				strcmp(PARSER_RECURSIVE_HELP_STRING,current_token))
 			{
-				command=strstr(state->command_string,current_token);
-				if (ALLOCATE(system_command,char,strlen(command)+1))
+				int background = 0;
+				const char *command_start = state->command_string;
+				if (fuzzy_string_compare_same_length(current_token, "wait"))
+				{
+					int job_id = 0;
+					shift_Parse_state(state, 1);
+					if (state->current_token &&
+						(1 != sscanf(state->current_token, "%d", &job_id)))
+					{
+						display_message(ERROR_MESSAGE, "system wait:  Invalid job id '%s'",
+							state->current_token);
+						display_parse_state_location(state);
+					}
+					else
+					{
+						return_code = Background_job_list_wait(
+							command_data->background_job_list, job_id);
+					}
+				}
+				else if (fuzzy_string_compare_same_length(current_token, "jobs"))
 				{
-					strcpy(system_command,command);
-					parse_variable(&system_command);
-					//system commands return 0 for no error
-					return_code = !system(system_command);
-					DEALLOCATE(system_command);
+					return_code = Background_job_list_list(command_data->background_job_list);
 				}
 				else
 				{
-					display_message(ERROR_MESSAGE,
-						"execute_command_system.  Insufficient memory");
-					return_code=0;
+					if (fuzzy_string_compare_same_length(current_token, "background"))
+					{
+						background = 1;
+						/* find the command after the background token */
+						command_start = strstr(command_start, current_token) + strlen(current_token);
+						shift_Parse_state(state, 1);
+						current_token = state->current_token;
+					}
+					if (!current_token)
+					{
+						display_message(ERROR_MESSAGE, "system background:  Missing command");
+					}
+					else if (ALLOCATE(system_command, char,
+						strlen(command = strstr(command_start, current_token)) + 1))
+					{
+						strcpy(system_command,command);
+						parse_variable(&system_command);
+						if (background)
+						{
+							int job_id = 0;
+							return_code = Background_job_list_start(
+								command_data->background_job_list, system_command, &job_id);
+							if (return_code)
+							{
+								display_message(INFORMATION_MESSAGE, "[job %d] Started: %s\n",
+									job_id, system_command);
+							}
+						}
+						else
+						{
+							//system commands return 0 for no error
+							return_code = !system(system_command);
+						}
+						DEALLOCATE(system_command);
+					}
+					else
+					{
+						display_message(ERROR_MESSAGE,
+							"execute_command_system.  Insufficient memory");
+						return_code=0;
+					}
 				}
 			}
 			else
 			{
-				/* no help */
+				display_message(INFORMATION_MESSAGE,
+					"\n  COMMAND_STRING\n"
+					"  background COMMAND_STRING\n"
+					"  jobs\n"
+					"  wait [JOB]\n"
+					"Run COMMAND_STRING with the shell, blocking until it finishes. "
+					"With background, return at once with a job id; output of the job "
+					"is written to the command window as it arrives. "
+					"Wait for background JOB, or all jobs, to finish with wait, "
+					"which fails if any exit status was non-zero. "
+					"List background jobs with jobs.\n");
 				return_code=1;
 			}
 		}
@@ -15637,6 +17164,12 @@ DESCRIPTION:
 				"cmiss_execute_command.  Could not create parse state");
 			return_code=0;
 		}
+		/* write output of background jobs, as timeouts do not fire while
+			 command files are executing */
+		if (command_data->background_job_list)
+		{
+			Background_job_list_poll(command_data->background_job_list);
+		}
 	}
 	else
 	{
@@ -15802,6 +17335,12 @@ Execute a <command_string>. If there is a command
 				"cmiss_execute_command.  Could not create parse state");
 			return_code=0;
 		}
+		/* write output of background jobs, as timeouts do not fire while
+			 command files are executing */
+		if (command_data->background_job_list)
+		{
+			Background_job_list_poll(command_data->background_job_list);
+		}
 	}
 	else
 	{
@@ -16166,6 +17705,9 @@ Parses command line options from <state>.
 		/* -server */
 		Option_table_add_entry(option_table, "-server",
 			&(command_line_options->server_mode_flag), NULL, set_char_flag);
+		/* -startup_profile */
+		Option_table_add_entry(option_table, "-startup_profile",
+			&(command_line_options->startup_profile_flag), NULL, set_char_flag);
 #if defined (CARBON_USER_INTERFACE) || (defined (WX_USER_INTERFACE) && defined (DARWIN))
 		/* -psn */
 		Option_table_add_entry(option_table, "-psn", NULL, NULL, ignore_entry);
@@ -16215,6 +17757,7 @@ int cmzn_command_data_process_command_line(int argc, char *argv[],
 	command_line_options->no_display_flag = (char)0;
 	command_line_options->random_number_seed = -1;
 	command_line_options->server_mode_flag = (char)0;
+	command_line_options->startup_profile_flag = (char)0;
 	command_line_options->visual_id_number = 0;
 	command_line_options->command_file_name = NULL;
 
@@ -16242,6 +17785,83 @@ int cmzn_command_data_process_command_line(int argc, char *argv[],
 	return return_code;
 }
 
+/* time main started, if recorded; start of the -startup_profile total */
+static int program_start_time_recorded = 0;
+static struct timeval program_start_time;
+
+void cmzn_command_data_record_program_start_time(void)
+{
+	cmgui_gettimeofday(&program_start_time, (struct timezone *)NULL);
+	program_start_time_recorded = 1;
+}
+
+/***************************************************************************//**
+ * Records the time taken by each phase of cmgui startup for -startup_profile.
+ * Timing starts when main recorded the program start time, otherwise when the
+ * command data is created, in which case the total is reported as partial.
+ */
+class Startup_profile
+{
+	bool enabled, from_program_start;
+	struct timeval start_time, phase_start_time;
+	std::vector<std::string> phase_names;
+	std::vector<double> phase_seconds;
+
+public:
+
+	Startup_profile() :
+		enabled(false),
+		from_program_start(0 != program_start_time_recorded)
+	{
+		cmgui_gettimeofday(&this->phase_start_time, (struct timezone *)NULL);
+		if (this->from_program_start)
+		{
+			this->start_time = program_start_time;
+			this->phase_names.push_back("context and user interface");
+			this->phase_seconds.push_back(
+				cmgui_get_elapsed_seconds(&this->start_time, &this->phase_start_time));
+		}
+		else
+		{
+			this->start_time = this->phase_start_time;
+		}
+	}
+
+	void setEnabled(bool enabledIn)
+	{
+		this->enabled = enabledIn;
+	}
+
+	/** Ends the current phase, naming it, and starts the next */
+	void endPhase(const char *name)
+	{
+		struct timeval end_time;
+		cmgui_gettimeofday(&end_time, (struct timezone *)NULL);
+		this->phase_names.push_back(name);
+		this->phase_seconds.push_back(cmgui_get_elapsed_seconds(&this->phase_start_time, &end_time));
+		this->phase_start_time = end_time;
+	}
+
+	void list() const
+	{
+		if (!this->enabled)
+			return;
+		struct timeval end_time;
+		cmgui_gettimeofday(&end_time, (struct timezone *)NULL);
+		const double total_seconds = cmgui_get_elapsed_seconds(&this->start_time, &end_time);
+		display_message(INFORMATION_MESSAGE, "Startup profile:\n");
+		for (size_t i = 0; i < this->phase_names.size(); ++i)
+		{
+			display_message(INFORMATION_MESSAGE, "  %-32s %10.6f s %5.1f%%\n",
+				this->phase_names[i].c_str(), this->phase_seconds[i],
+				(0.0 < total_seconds) ? 100.0*this->phase_seconds[i]/total_seconds : 0.0);
+		}
+		display_message(INFORMATION_MESSAGE, "  %-32s %10.6f s\n",
+			this->from_program_start ? "total" : "total (from command data creation)",
+			total_seconds);
+	}
+};
+
 struct cmzn_command_data *CREATE(cmzn_command_data)(struct cmzn_context_app *context,
 	struct User_interface_module *UI_module)
 /*******************************************************************************
@@ -16269,6 +17889,7 @@ Initialise all the subcomponents of cmgui and create the cmzn_command_data
 	struct Option_table *option_table;
 	struct Parse_state *state;
 	User_settings user_settings;
+	Startup_profile startup_profile;
 #if defined (WIN32_USER_INTERFACE)
 	ENTER(WinMain);
 #endif /* defined (WIN32_USER_INTERFACE) */
@@ -16325,6 +17946,11 @@ Initialise all the subcomponents of cmgui and create the cmzn_command_data
 		command_data->io_stream_package = (struct IO_stream_package *)NULL;
 		command_data->computed_field_package=(struct Computed_field_package *)NULL;
 		command_data->default_scene=(struct Scene *)NULL;
+		command_data->spectrum_autorange_cache = CREATE(Spectrum_autorange_cache)();
+		command_data->minimise_package = (struct Minimise_package *)NULL;
+		command_data->scene_transformation_table = (struct Scene_transformation_table *)NULL;
+		command_data->background_job_list = (struct Background_job_list *)NULL;
+		command_data->region_path_cache = (struct Region_path_cache *)NULL;
 		command_data->scene_manager=(struct MANAGER(Scene) *)NULL;
 #if defined (WIN32_USER_INTERFACE) || defined (GTK_USER_INTERFACE) || defined (WX_USER_INTERFACE)
 		command_data->command_window=(struct Command_window *)NULL;
@@ -16403,6 +18029,7 @@ Initialise all the subcomponents of cmgui and create the cmzn_command_data
 		command_line_options.no_display_flag = (char)no_display;
 		command_line_options.random_number_seed = non_random;
 		command_line_options.server_mode_flag = (char)server_mode;
+		command_line_options.startup_profile_flag = (char)0;
 		command_line_options.visual_id_number = visual_id;
 		command_line_options.command_file_name = comfile_name;
 
@@ -16444,6 +18071,7 @@ Initialise all the subcomponents of cmgui and create the cmzn_command_data
 		server_mode = (int)command_line_options.server_mode_flag;
 		visual_id = command_line_options.visual_id_number;
 		comfile_name = command_line_options.command_file_name;
+		startup_profile.setEnabled(0 != command_line_options.startup_profile_flag);
 		if (write_help)
 		{
 			char *double_question_mark = new char[3];
@@ -16460,6 +18088,7 @@ Initialise all the subcomponents of cmgui and create the cmzn_command_data
 			destroy_Parse_state(&state);
             delete[] double_question_mark;
 		}
+		startup_profile.endPhase("command line");
 
 		command_data->io_stream_package = cmzn_context_get_default_IO_stream_package(cmzn_context_app_get_core_context(context));
 
@@ -16547,6 +18176,7 @@ Initialise all the subcomponents of cmgui and create the cmzn_command_data
 		command_data->cm_parameters_file_name = cm_parameters_file_name;
 		command_data->help_directory = user_settings.help_directory;
 		command_data->help_url = user_settings.help_url;
+		startup_profile.endPhase("interpreter and event dispatcher");
 
 		/* create the managers */
 
@@ -16636,6 +18266,7 @@ Initialise all the subcomponents of cmgui and create the cmzn_command_data
 		command_data->glyphmodule = cmzn_graphics_module_get_glyphmodule(command_data->graphics_module);
 		cmzn_glyphmodule_define_standard_glyphs(command_data->glyphmodule);
 		cmzn_glyphmodule_define_standard_cmgui_glyphs(command_data->glyphmodule);
+		startup_profile.endPhase("materials, spectra and glyphs");
 
 #if defined (USE_CMGUI_GRAPHICS_WINDOW)
 		command_data->graphics_buffer_package = UI_module->graphics_buffer_package;
@@ -16649,6 +18280,14 @@ Initialise all the subcomponents of cmgui and create the cmzn_command_data
 		command_data->basis_manager=CREATE(MANAGER(FE_basis))();
 
 		command_data->root_region = cmzn_context_get_default_region(cmzn_context_app_get_core_context(context));
+		command_data->minimise_package = CREATE(Minimise_package)(
+			command_data->root_region, command_data->event_dispatcher,
+			(UI_module->default_time_keeper_app) ?
+				UI_module->default_time_keeper_app->getTimeKeeper() : (cmzn_timekeeper_id)NULL);
+		command_data->background_job_list = CREATE(Background_job_list)(
+			command_data->event_dispatcher);
+		command_data->region_path_cache = CREATE(Region_path_cache)(
+			command_data->root_region);
 
 #if defined (SELECT_DESCRIPTORS)
 		/* create device list */
@@ -16661,6 +18300,7 @@ Initialise all the subcomponents of cmgui and create the cmzn_command_data
 
 		/* interactive_tool manager */
 		command_data->interactive_tool_manager=UI_module->interactive_tool_manager;
+		startup_profile.endPhase("regions and managers");
 		/* computed field manager and default computed fields zero, xi,
 			default_coordinate, etc. */
 		/*???RC should the default computed fields be established in
@@ -16782,8 +18422,14 @@ Initialise all the subcomponents of cmgui and create the cmzn_command_data
 				command_data->computed_field_package);
 #endif /* defined (ZINC_USE_ITK) */
 		}
+		startup_profile.endPhase("field types");
 		/* graphics_module */
 		command_data->default_time_keeper_app=ACCESS(Time_keeper_app)(UI_module->default_time_keeper_app);
+		if (command_data->default_time_keeper_app)
+		{
+			command_data->scene_transformation_table = CREATE(Scene_transformation_table)(
+				command_data->root_region, command_data->default_time_keeper_app);
+		}
 
 		/* scene manager */
 		/*???RC & SAB.   LOTS of managers need to be created before this
@@ -16821,6 +18467,8 @@ Initialise all the subcomponents of cmgui and create the cmzn_command_data
 		}
 #endif /* defined (USE_CMGUI_GRAPHICS_WINDOW) */
 
+		startup_profile.endPhase("time keeper, scene and tools");
+
 		/* properly set up the Execute_command objects */
 		Execute_command_set_command_function(command_data->execute_command,
 			cmiss_execute_command, (void *)command_data);
@@ -16887,6 +18535,7 @@ Initialise all the subcomponents of cmgui and create the cmzn_command_data
 				}
 			}
 		}
+		startup_profile.endPhase("main window");
 
 		if (return_code && (!command_list) && (!write_help))
 		{
@@ -16910,16 +18559,19 @@ Initialise all the subcomponents of cmgui and create the cmzn_command_data
 				/* start the back-end */
 				cmiss_execute_command(global_temp_string,
 					(void *)command_data);
+				startup_profile.endPhase("cm back-end");
 			}
 			if (user_settings.startup_comfile)
 			{
 				/* Can't get the startupComfile name without X at the moment */
 				cmgui_execute_comfile(user_settings.startup_comfile, NULL,
 					NULL, NULL, (char **)NULL, command_data->execute_command);
+				startup_profile.endPhase("startup comfile");
 			}
 			if (execute_string)
 			{
 				cmiss_execute_command(execute_string,(void *)command_data);
+				startup_profile.endPhase("execute string");
 			}
 			if (example_id||comfile_name)
 			{
@@ -16928,8 +18580,10 @@ Initialise all the subcomponents of cmgui and create the cmzn_command_data
 					command_data->examples_directory,
 					CMGUI_EXAMPLE_DIRECTORY_SYMBOL, &command_data->example_comfile,
 					command_data->execute_command);
+				startup_profile.endPhase("command file");
 			}
 		}
+		startup_profile.list();
 
 		if ((!command_list) && (!write_help))
 		{
@@ -17047,6 +18701,22 @@ NOTE: Do not call this directly: call cmzn_command_data_destroy() to deaccess.
 		cmzn_loggernotifier_clear_callback(command_data->loggerNotifier);
 		cmzn_loggernotifier_destroy(&command_data->loggerNotifier);
 		cmzn_logger_destroy(&command_data->logger);
+		DESTROY(Spectrum_autorange_cache)(&command_data->spectrum_autorange_cache);
+		DESTROY(Minimise_package)(&command_data->minimise_package);
+		if (command_data->background_job_list)
+		{
+			DESTROY(Background_job_list)(&command_data->background_job_list);
+		}
+		if (command_data->region_path_cache)
+		{
+			DESTROY(Region_path_cache)(&command_data->region_path_cache);
+		}
+		if (command_data->scene_transformation_table)
+		{
+			DESTROY(Scene_transformation_table)(&command_data->scene_transformation_table);
+		}
+		/* saves the image filter cache use order */
+		Image_filter_cache_set_directory((const char *)NULL, /*maximum_megabytes*/0.0);
 		DEACCESS(Scene)(&command_data->default_scene);
 		cmzn_glyphmodule_destroy(&command_data->glyphmodule);
 		DEACCESS(Time_keeper_app)(&command_data->default_time_keeper_app);
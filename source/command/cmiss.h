@@ -68,6 +68,7 @@ Command line options to be parsed by read_cmgui_command_line_options.
 	char mycm_start_flag;
 	char no_display_flag;
 	char server_mode_flag;
+	char startup_profile_flag;
 	int random_number_seed;
 	int visual_id_number;
 	/* default option; no token */
@@ -228,6 +229,13 @@ int cmzn_command_data_set_cmgui_string(struct cmzn_command_data *command_data,
 	const char *name_string, const char *version_string,const char *date_string,
 	const char *copyright_string, const char *build_string, const char *revision_string);
 
+/**
+ * Records the current time as the start of the program. Call first thing in
+ * main so -startup_profile also times context and user interface creation
+ * done before the command data is created.
+ */
+void cmzn_command_data_record_program_start_time(void);
+
 /***************************************************************************//**
  * Process command line options.
  *
@@ -5,6 +5,7 @@
 * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 
+#include "opencmiss/zinc/element.h"
 #include "command/parser.h"
 
 #include "general/debug.h"
@@ -370,3 +371,31 @@ cmzn_element *cmzn_element_get_first_top_level_ancestor(cmzn_element *element)
 	}
 	return 0;
 }
+
+int cmzn_element_get_centroid_xi(cmzn_element *element, double *xi)
+{
+	if (!(element && xi))
+		return 0;
+	const int dimension = cmzn_element_get_dimension(element);
+	for (int i = 0; i < dimension; ++i)
+		xi[i] = 0.5;
+	switch (cmzn_element_get_shape_type(element))
+	{
+	case CMZN_ELEMENT_SHAPE_TYPE_TRIANGLE:
+	case CMZN_ELEMENT_SHAPE_TYPE_WEDGE12:
+		xi[0] = xi[1] = 1.0/3.0;
+		break;
+	case CMZN_ELEMENT_SHAPE_TYPE_WEDGE13:
+		xi[0] = xi[2] = 1.0/3.0;
+		break;
+	case CMZN_ELEMENT_SHAPE_TYPE_WEDGE23:
+		xi[1] = xi[2] = 1.0/3.0;
+		break;
+	case CMZN_ELEMENT_SHAPE_TYPE_TETRAHEDRON:
+		xi[0] = xi[1] = xi[2] = 0.25;
+		break;
+	default:
+		break;
+	}
+	return dimension;
+}
@@ -60,5 +60,14 @@ struct cmzn_element_face_type_to_string
 /** @return  Non-accessed first top-level ancestor element for supplied element. Can return itself. */
 cmzn_element *cmzn_element_get_first_top_level_ancestor(cmzn_element *element);
 
+/**
+ * Gets the element xi coordinates of the centroid of the element's shape:
+ * 0.5 on line chart directions, 1/3 on triangle and 1/4 on tetrahedron
+ * chart directions.
+ * @param xi  Array of at least 3 values to receive the centroid.
+ * @return  Element dimension, or 0 if invalid.
+ */
+int cmzn_element_get_centroid_xi(cmzn_element *element, double *xi);
+
 #endif
 
@@ -0,0 +1,305 @@
+/**
+ * FILE : finite_element_list_file_app.cpp
+ *
+ * Writes field values at nodes or elements to CSV or binary files.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <limits>
+#include <string.h>
+#include "opencmiss/zinc/core.h"
+#include "opencmiss/zinc/element.h"
+#include "opencmiss/zinc/field.h"
+#include "opencmiss/zinc/fieldcache.h"
+#include "opencmiss/zinc/fieldfiniteelement.h"
+#include "opencmiss/zinc/fieldmodule.h"
+#include "opencmiss/zinc/node.h"
+#include "opencmiss/zinc/status.h"
+#include "command/parser.h"
+#include "general/debug.h"
+#include "general/message.h"
+#include "finite_element/finite_element_app.h"
+#include "finite_element/finite_element_list_file_app.hpp"
+
+namespace {
+
+const char FE_LIST_FILE_BINARY_MAGIC[] = "CMLIST01";
+const size_t FE_LIST_FILE_BINARY_MAGIC_SIZE = 8;
+const size_t FE_LIST_FILE_BUFFER_SIZE = 1 << 20;
+
+/**
+ * @return  name as a CSV field: enclosed in double quotes with any double
+ * quotes doubled if it contains a comma, double quote or line break.
+ */
+std::string FE_list_file_csv_quote(const std::string &name)
+{
+	if (std::string::npos == name.find_first_of(",\"\r\n"))
+		return name;
+	std::string quoted_name("\"");
+	for (size_t i = 0; i < name.size(); ++i)
+	{
+		if (name[i] == '"')
+			quoted_name += '"';
+		quoted_name += name[i];
+	}
+	quoted_name += '"';
+	return quoted_name;
+}
+
+}
+
+int FE_list_file_format_from_string(const char *name,
+	enum FE_list_file_format *format_address)
+{
+	if (!(name && format_address))
+		return 0;
+	if (0 == strcmp(name, "csv"))
+		*format_address = FE_LIST_FILE_FORMAT_CSV;
+	else if (0 == strcmp(name, "binary"))
+		*format_address = FE_LIST_FILE_FORMAT_BINARY;
+	else
+		return 0;
+	return 1;
+}
+
+int set_FE_list_file_format(struct Parse_state *state,
+	void *format_address_void, void *dummy_user_data)
+{
+	USE_PARAMETER(dummy_user_data);
+	enum FE_list_file_format *format_address =
+		static_cast<enum FE_list_file_format *>(format_address_void);
+	if (!(state && format_address))
+	{
+		display_message(ERROR_MESSAGE,
+			"set_FE_list_file_format.  Invalid argument(s)");
+		return 0;
+	}
+	const char *current_token = state->current_token;
+	if (!current_token)
+	{
+		display_message(ERROR_MESSAGE, "Missing list file format");
+		display_parse_state_location(state);
+		return 0;
+	}
+	if (strcmp(PARSER_HELP_STRING, current_token) &&
+		strcmp(PARSER_RECURSIVE_HELP_STRING, current_token))
+	{
+		if (!FE_list_file_format_from_string(current_token, format_address))
+		{
+			display_message(ERROR_MESSAGE, "Invalid list file format %s", current_token);
+			display_parse_state_location(state);
+			return 0;
+		}
+		return shift_Parse_state(state, 1);
+	}
+	display_message(INFORMATION_MESSAGE, " csv|binary[%s]",
+		(*format_address == FE_LIST_FILE_FORMAT_BINARY) ? "binary" : "csv");
+	return 1;
+}
+
+FE_list_file_writer::FE_list_file_writer(const char *file_name,
+	enum FE_list_file_format formatIn, cmzn_fieldmodule_id fieldmodule, double time) :
+	file(0),
+	format(formatIn),
+	fieldcache(cmzn_fieldmodule_create_fieldcache(fieldmodule)),
+	buffer(FE_LIST_FILE_BUFFER_SIZE),
+	buffer_size(0),
+	number_of_objects(0),
+	error(false)
+{
+	cmzn_fieldcache_set_time(this->fieldcache, time);
+	cmzn_fielditerator_id iter = cmzn_fieldmodule_create_fielditerator(fieldmodule);
+	cmzn_field_id field;
+	int offset = 0;
+	while (0 != (field = cmzn_fielditerator_next(iter)))
+	{
+		cmzn_field_finite_element_id finite_element_field = cmzn_field_cast_finite_element(field);
+		if (finite_element_field &&
+			(CMZN_FIELD_VALUE_TYPE_REAL == cmzn_field_get_value_type(field)))
+		{
+			char *field_name = cmzn_field_get_name(field);
+			const int number_of_components = cmzn_field_get_number_of_components(field);
+			for (int c = 1; c <= number_of_components; ++c)
+			{
+				char *component_name = cmzn_field_get_component_name(field, c);
+				std::string column_name(field_name);
+				column_name += '.';
+				column_name += component_name;
+				this->column_names.push_back(column_name);
+				cmzn_deallocate(component_name);
+			}
+			cmzn_deallocate(field_name);
+			this->fields.push_back(field);
+			this->field_offsets.push_back(offset);
+			offset += number_of_components;
+			field = 0;
+		}
+		cmzn_field_finite_element_destroy(&finite_element_field);
+		cmzn_field_destroy(&field);
+	}
+	cmzn_fielditerator_destroy(&iter);
+	this->values.resize(offset);
+	this->file = fopen(file_name, (this->format == FE_LIST_FILE_FORMAT_BINARY) ? "wb" : "w");
+	if (this->file)
+	{
+		this->writeHeader();
+	}
+	else
+	{
+		display_message(ERROR_MESSAGE,
+			"FE_list_file_writer.  Could not open file %s", file_name);
+	}
+}
+
+FE_list_file_writer::~FE_list_file_writer()
+{
+	if (this->file)
+		this->finish();
+	for (size_t i = 0; i < this->fields.size(); ++i)
+		cmzn_field_destroy(&(this->fields[i]));
+	cmzn_fieldcache_destroy(&this->fieldcache);
+}
+
+void FE_list_file_writer::write(const void *data, size_t size)
+{
+	if (this->buffer_size + size > this->buffer.size())
+	{
+		if ((0 < this->buffer_size) &&
+			(this->buffer_size != fwrite(&(this->buffer[0]), 1, this->buffer_size, this->file)))
+		{
+			this->error = true;
+		}
+		this->buffer_size = 0;
+		if (size > this->buffer.size())
+		{
+			if (size != fwrite(data, 1, size, this->file))
+				this->error = true;
+			return;
+		}
+	}
+	memcpy(&(this->buffer[this->buffer_size]), data, size);
+	this->buffer_size += size;
+}
+
+void FE_list_file_writer::writeHeader()
+{
+	if (this->format == FE_LIST_FILE_FORMAT_BINARY)
+	{
+		this->write(FE_LIST_FILE_BINARY_MAGIC, FE_LIST_FILE_BINARY_MAGIC_SIZE);
+		const int number_of_columns = static_cast<int>(this->column_names.size());
+		this->write(&number_of_columns, sizeof(int));
+		for (int i = 0; i < number_of_columns; ++i)
+		{
+			const int length = static_cast<int>(this->column_names[i].size());
+			this->write(&length, sizeof(int));
+			this->write(this->column_names[i].data(), length);
+		}
+	}
+	else
+	{
+		std::string header("identifier");
+		for (size_t i = 0; i < this->column_names.size(); ++i)
+		{
+			header += ',';
+			header += FE_list_file_csv_quote(this->column_names[i]);
+		}
+		header += '\n';
+		this->write(header.data(), header.size());
+	}
+}
+
+/**
+ * Evaluates all fields at the location set in the field cache and writes
+ * them with identifier.
+ */
+int FE_list_file_writer::writeRecord(int identifier)
+{
+	if (!this->file)
+		return 0;
+	const size_t number_of_fields = this->fields.size();
+	if (this->format == FE_LIST_FILE_FORMAT_BINARY)
+	{
+		const double undefined = std::numeric_limits<double>::quiet_NaN();
+		for (size_t f = 0; f < number_of_fields; ++f)
+		{
+			const int number_of_components = cmzn_field_get_number_of_components(this->fields[f]);
+			double *field_values = &(this->values[this->field_offsets[f]]);
+			if (CMZN_OK != cmzn_field_evaluate_real(this->fields[f], this->fieldcache,
+				number_of_components, field_values))
+			{
+				for (int c = 0; c < number_of_components; ++c)
+					field_values[c] = undefined;
+			}
+		}
+		this->write(&identifier, sizeof(int));
+		if (!this->values.empty())
+			this->write(&(this->values[0]), this->values.size()*sizeof(double));
+	}
+	else
+	{
+		char text[32];
+		int length = sprintf(text, "%d", identifier);
+		this->write(text, length);
+		for (size_t f = 0; f < number_of_fields; ++f)
+		{
+			const int number_of_components = cmzn_field_get_number_of_components(this->fields[f]);
+			double *field_values = &(this->values[this->field_offsets[f]]);
+			const bool defined = (CMZN_OK == cmzn_field_evaluate_real(this->fields[f],
+				this->fieldcache, number_of_components, field_values));
+			for (int c = 0; c < number_of_components; ++c)
+			{
+				if (defined)
+				{
+					length = sprintf(text, ",%.17g", field_values[c]);
+					this->write(text, length);
+				}
+				else
+				{
+					this->write(",", 1);
+				}
+			}
+		}
+		this->write("\n", 1);
+	}
+	++(this->number_of_objects);
+	return 1;
+}
+
+int FE_list_file_writer::addNode(cmzn_node_id node)
+{
+	cmzn_fieldcache_set_node(this->fieldcache, node);
+	return this->writeRecord(cmzn_node_get_identifier(node));
+}
+
+int FE_list_file_writer::addElement(cmzn_element_id element)
+{
+	double xi[3];
+	const int dimension = cmzn_element_get_centroid_xi(element, xi);
+	cmzn_fieldcache_set_mesh_location(this->fieldcache, element, dimension, xi);
+	return this->writeRecord(cmzn_element_get_identifier(element));
+}
+
+int FE_list_file_writer::finish()
+{
+	if (!this->file)
+		return 0;
+	if ((0 < this->buffer_size) &&
+		(this->buffer_size != fwrite(&(this->buffer[0]), 1, this->buffer_size, this->file)))
+	{
+		this->error = true;
+	}
+	this->buffer_size = 0;
+	if (0 != fclose(this->file))
+		this->error = true;
+	this->file = 0;
+	if (this->error)
+	{
+		display_message(ERROR_MESSAGE, "FE_list_file_writer.  Error writing file");
+		return 0;
+	}
+	return 1;
+}
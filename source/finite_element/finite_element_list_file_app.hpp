@@ -0,0 +1,119 @@
+/**
+ * FILE : finite_element_list_file_app.hpp
+ *
+ * Writes field values at nodes or elements to CSV or binary files.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#if !defined (FINITE_ELEMENT_LIST_FILE_APP_HPP)
+#define FINITE_ELEMENT_LIST_FILE_APP_HPP
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "opencmiss/zinc/types/elementid.h"
+#include "opencmiss/zinc/types/fieldcacheid.h"
+#include "opencmiss/zinc/types/fieldid.h"
+#include "opencmiss/zinc/types/fieldmoduleid.h"
+#include "opencmiss/zinc/types/nodeid.h"
+
+struct Parse_state;
+
+enum FE_list_file_format
+{
+	FE_LIST_FILE_FORMAT_CSV,
+	FE_LIST_FILE_FORMAT_BINARY
+};
+
+/**
+ * Gets the list file format from its name: csv or binary.
+ * @return  1 on success with format set, 0 if name not recognised.
+ */
+int FE_list_file_format_from_string(const char *name,
+	enum FE_list_file_format *format_address);
+
+/**
+ * Modifier function setting the list file format from the next token, csv or
+ * binary, which are listed in help with the current value.
+ * @param format_address_void  Address of enum FE_list_file_format.
+ */
+int set_FE_list_file_format(struct Parse_state *state,
+	void *format_address_void, void *dummy_user_data);
+
+/**
+ * Writes the identifier and the values of all real finite element fields of
+ * a field module at each node or element added, bypassing the message system
+ * through a large output buffer. Element values are evaluated at the centroid
+ * of the element shape.
+ *
+ * CSV files have a header line naming each column FIELD.COMPONENT, quoted if
+ * it contains a comma or double quote, and leave values of fields not defined
+ * at an object empty. Binary files start with
+ * the 8 characters "CMLIST01" then, in native byte order, a 32-bit number of
+ * value columns and for each a 32-bit name length and name, followed by one
+ * record per object of a 32-bit identifier and a double per column, NaN where
+ * the field is not defined.
+ */
+class FE_list_file_writer
+{
+	FILE *file;
+	enum FE_list_file_format format;
+	cmzn_fieldcache_id fieldcache;
+	std::vector<cmzn_field_id> fields;
+	std::vector<int> field_offsets;
+	std::vector<std::string> column_names;
+	std::vector<double> values;
+	std::vector<char> buffer;
+	size_t buffer_size;
+	int number_of_objects;
+	bool error;
+
+	void write(const void *data, size_t size);
+
+	void writeHeader();
+
+	int writeRecord(int identifier);
+
+public:
+
+	/**
+	 * Open file_name and write its header.
+	 * @param time  Time at which fields are evaluated.
+	 */
+	FE_list_file_writer(const char *file_name, enum FE_list_file_format format,
+		cmzn_fieldmodule_id fieldmodule, double time);
+
+	~FE_list_file_writer();
+
+	/** @return  true if the file was opened */
+	bool isValid() const
+	{
+		return (0 != this->file);
+	}
+
+	int addNode(cmzn_node_id node);
+
+	int addElement(cmzn_element_id element);
+
+	/**
+	 * Flushes remaining output and closes the file.
+	 * @return  1 on success, 0 if any write failed.
+	 */
+	int finish();
+
+	int getNumberOfObjects() const
+	{
+		return this->number_of_objects;
+	}
+
+	int getNumberOfColumns() const
+	{
+		return static_cast<int>(this->column_names.size());
+	}
+};
+
+#endif /* !defined (FINITE_ELEMENT_LIST_FILE_APP_HPP) */
@@ -0,0 +1,509 @@
+/**
+ * FILE : finite_element_renumber_app.cpp
+ *
+ * Renumbering of nodes and elements in space filling curve order.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include "opencmiss/zinc/element.h"
+#include "opencmiss/zinc/field.h"
+#include "opencmiss/zinc/fieldcache.h"
+#include "opencmiss/zinc/fieldmodule.h"
+#include "opencmiss/zinc/mesh.h"
+#include "opencmiss/zinc/node.h"
+#include "opencmiss/zinc/nodeset.h"
+#include "opencmiss/zinc/status.h"
+#include "command/parser.h"
+#include "general/debug.h"
+#include "general/message.h"
+#include "general/mystring.h"
+#include "finite_element/finite_element_app.h"
+#include "finite_element/finite_element_renumber_app.hpp"
+
+namespace {
+
+const int maximumCurveDimension = 3;
+
+struct Curve_point
+{
+	unsigned long long key;
+	int identifier;
+	int index;
+
+	bool operator<(const Curve_point& other) const
+	{
+		if (this->key != other.key)
+			return this->key < other.key;
+		return this->identifier < other.identifier;
+	}
+};
+
+/**
+ * Returns the number of bits per dimension, filling at most 63 bits of key.
+ */
+inline int getCurveBits(int dimension)
+{
+	const int bits = 63/dimension;
+	return (bits > 31) ? 31 : bits;
+}
+
+/**
+ * Converts integer coordinates to the Hilbert transpose in place. See
+ * J. Skilling, Programming the Hilbert curve, AIP Conf. Proc. 707 (2004).
+ */
+void axesToHilbertTranspose(unsigned int *x, int bits, int dimension)
+{
+	const unsigned int m = 1U << (bits - 1);
+	for (unsigned int q = m; q > 1; q >>= 1)
+	{
+		const unsigned int p = q - 1;
+		for (int i = 0; i < dimension; ++i)
+		{
+			if (x[i] & q)
+			{
+				x[0] ^= p;
+			}
+			else
+			{
+				const unsigned int t = (x[0] ^ x[i]) & p;
+				x[0] ^= t;
+				x[i] ^= t;
+			}
+		}
+	}
+	for (int i = 1; i < dimension; ++i)
+		x[i] ^= x[i - 1];
+	unsigned int t = 0;
+	for (unsigned int q = m; q > 1; q >>= 1)
+	{
+		if (x[dimension - 1] & q)
+			t ^= q - 1;
+	}
+	for (int i = 0; i < dimension; ++i)
+		x[i] ^= t;
+}
+
+unsigned long long getCurveKey(const double *values, int dimension,
+	const double *minimums, const double *maximums,
+	enum Space_filling_curve_type curve_type)
+{
+	const int bits = getCurveBits(dimension);
+	const double maximumCoordinate = (double)((1U << bits) - 1);
+	unsigned int x[maximumCurveDimension];
+	for (int i = 0; i < dimension; ++i)
+	{
+		const double range = maximums[i] - minimums[i];
+		double scaled = (range > 0.0) ? maximumCoordinate*(values[i] - minimums[i])/range : 0.0;
+		if (!(scaled > 0.0))
+			scaled = 0.0;
+		else if (scaled > maximumCoordinate)
+			scaled = maximumCoordinate;
+		x[i] = (unsigned int)scaled;
+	}
+	if (SPACE_FILLING_CURVE_HILBERT == curve_type)
+		axesToHilbertTranspose(x, bits, dimension);
+	/* interleave bits, most significant first */
+	unsigned long long key = 0;
+	for (int b = bits - 1; b >= 0; --b)
+	{
+		for (int i = 0; i < dimension; ++i)
+			key = (key << 1) | ((x[i] >> b) & 1U);
+	}
+	return key;
+}
+
+/** Node and element access through one interface for the renumber template */
+struct Node_renumber_traits
+{
+	typedef cmzn_nodeset_id Domain;
+	typedef cmzn_node_id Object;
+	typedef cmzn_nodeiterator_id Iterator;
+
+	static Iterator createIterator(Domain nodeset)
+	{
+		return cmzn_nodeset_create_nodeiterator(nodeset);
+	}
+	static Object next(Iterator iterator)
+	{
+		return cmzn_nodeiterator_next(iterator);
+	}
+	static void destroyIterator(Iterator *iterator_address)
+	{
+		cmzn_nodeiterator_destroy(iterator_address);
+	}
+	static void destroy(Object *node_address)
+	{
+		cmzn_node_destroy(node_address);
+	}
+	static Domain getMaster(Domain nodeset)
+	{
+		return cmzn_nodeset_get_master_nodeset(nodeset);
+	}
+	static void destroyDomain(Domain *nodeset_address)
+	{
+		cmzn_nodeset_destroy(nodeset_address);
+	}
+	static cmzn_fieldmodule_id getFieldmodule(Domain nodeset)
+	{
+		return cmzn_nodeset_get_fieldmodule(nodeset);
+	}
+	static bool contains(Domain nodeset, Object node)
+	{
+		return cmzn_nodeset_contains_node(nodeset, node);
+	}
+	static Object find(Domain nodeset, int identifier)
+	{
+		return cmzn_nodeset_find_node_by_identifier(nodeset, identifier);
+	}
+	static int getIdentifier(Object node)
+	{
+		return cmzn_node_get_identifier(node);
+	}
+	static int setIdentifier(Object node, int identifier)
+	{
+		return cmzn_node_set_identifier(node, identifier);
+	}
+	static int setLocation(cmzn_fieldcache_id fieldcache, Object node)
+	{
+		return cmzn_fieldcache_set_node(fieldcache, node);
+	}
+	static const char *objectName()
+	{
+		return "node";
+	}
+};
+
+struct Element_renumber_traits
+{
+	typedef cmzn_mesh_id Domain;
+	typedef cmzn_element_id Object;
+	typedef cmzn_elementiterator_id Iterator;
+
+	static Iterator createIterator(Domain mesh)
+	{
+		return cmzn_mesh_create_elementiterator(mesh);
+	}
+	static Object next(Iterator iterator)
+	{
+		return cmzn_elementiterator_next(iterator);
+	}
+	static void destroyIterator(Iterator *iterator_address)
+	{
+		cmzn_elementiterator_destroy(iterator_address);
+	}
+	static void destroy(Object *element_address)
+	{
+		cmzn_element_destroy(element_address);
+	}
+	static Domain getMaster(Domain mesh)
+	{
+		return cmzn_mesh_get_master_mesh(mesh);
+	}
+	static void destroyDomain(Domain *mesh_address)
+	{
+		cmzn_mesh_destroy(mesh_address);
+	}
+	static cmzn_fieldmodule_id getFieldmodule(Domain mesh)
+	{
+		return cmzn_mesh_get_fieldmodule(mesh);
+	}
+	static bool contains(Domain mesh, Object element)
+	{
+		return cmzn_mesh_contains_element(mesh, element);
+	}
+	static Object find(Domain mesh, int identifier)
+	{
+		return cmzn_mesh_find_element_by_identifier(mesh, identifier);
+	}
+	static int getIdentifier(Object element)
+	{
+		return cmzn_element_get_identifier(element);
+	}
+	static int setIdentifier(Object element, int identifier)
+	{
+		return cmzn_element_set_identifier(element, identifier);
+	}
+	/** elements are placed by their centroid */
+	static int setLocation(cmzn_fieldcache_id fieldcache, Object element)
+	{
+		double xi[3];
+		return cmzn_fieldcache_set_mesh_location(fieldcache, element,
+			cmzn_element_get_centroid_xi(element, xi), xi);
+	}
+	static const char *objectName()
+	{
+		return "element";
+	}
+};
+
+template <class Traits>
+int changeIdentifiersSpaceFillingCurve(typename Traits::Domain domain,
+	int offset, cmzn_field_id field, double time,
+	enum Space_filling_curve_type curve_type, const double *minimums,
+	const double *maximums, const char *function_name)
+{
+	typedef typename Traits::Object Object;
+	const int dimension = cmzn_field_get_number_of_components(field);
+	if ((!domain) || (dimension < 1) || (dimension > maximumCurveDimension))
+	{
+		display_message(ERROR_MESSAGE, "%s.  Invalid argument(s)", function_name);
+		return 0;
+	}
+	int return_code = 1;
+	cmzn_fieldmodule_id fieldmodule = Traits::getFieldmodule(domain);
+	cmzn_fieldcache_id fieldcache = cmzn_fieldmodule_create_fieldcache(fieldmodule);
+	cmzn_fieldcache_set_time(fieldcache, time);
+	std::vector<Object> objects;
+	std::vector<double> values;
+	typename Traits::Iterator iterator = Traits::createIterator(domain);
+	Object object;
+	double objectValues[maximumCurveDimension];
+	while (0 != (object = Traits::next(iterator)))
+	{
+		objects.push_back(object);
+		Traits::setLocation(fieldcache, object);
+		if (CMZN_OK != cmzn_field_evaluate_real(field, fieldcache, dimension, objectValues))
+		{
+			display_message(ERROR_MESSAGE, "%s.  Sort by field is not defined at %s %d",
+				function_name, Traits::objectName(), Traits::getIdentifier(object));
+			return_code = 0;
+			break;
+		}
+		values.insert(values.end(), objectValues, objectValues + dimension);
+	}
+	Traits::destroyIterator(&iterator);
+	cmzn_fieldcache_destroy(&fieldcache);
+	const int numberOfObjects = static_cast<int>(objects.size());
+	if (return_code && (0 < numberOfObjects))
+	{
+		double rangeMinimums[maximumCurveDimension], rangeMaximums[maximumCurveDimension];
+		if (!(minimums && maximums))
+		{
+			for (int i = 0; i < dimension; ++i)
+			{
+				rangeMinimums[i] = rangeMaximums[i] = values[i];
+			}
+			for (int j = 1; j < numberOfObjects; ++j)
+			{
+				for (int i = 0; i < dimension; ++i)
+				{
+					const double value = values[j*dimension + i];
+					if (value < rangeMinimums[i])
+						rangeMinimums[i] = value;
+					else if (value > rangeMaximums[i])
+						rangeMaximums[i] = value;
+				}
+			}
+			minimums = rangeMinimums;
+			maximums = rangeMaximums;
+		}
+		std::vector<Curve_point> points(numberOfObjects);
+		std::vector<int> identifiers(numberOfObjects);
+		for (int j = 0; j < numberOfObjects; ++j)
+		{
+			points[j].key = getCurveKey(&(values[j*dimension]), dimension, minimums, maximums, curve_type);
+			points[j].identifier = identifiers[j] = Traits::getIdentifier(objects[j]);
+			points[j].index = j;
+		}
+		std::sort(points.begin(), points.end());
+		/* objects keep the set of identifiers they already have, plus offset */
+		std::sort(identifiers.begin(), identifiers.end());
+		typename Traits::Domain master = Traits::getMaster(domain);
+		const long long maximumIdentifier = std::numeric_limits<int>::max();
+		if ((long long)identifiers[0] + offset < 1)
+		{
+			display_message(ERROR_MESSAGE, "%s.  Offset gives %s identifiers less than 1",
+				function_name, Traits::objectName());
+			return_code = 0;
+		}
+		else if ((long long)identifiers[numberOfObjects - 1] + offset > maximumIdentifier)
+		{
+			display_message(ERROR_MESSAGE, "%s.  Offset gives %s identifiers greater than %d",
+				function_name, Traits::objectName(), static_cast<int>(maximumIdentifier));
+			return_code = 0;
+		}
+		else if (offset != 0)
+		{
+			for (int j = 0; j < numberOfObjects; ++j)
+			{
+				Object existing = Traits::find(master, identifiers[j] + offset);
+				if (existing)
+				{
+					const bool clash = !Traits::contains(domain, existing);
+					Traits::destroy(&existing);
+					if (clash)
+					{
+						display_message(ERROR_MESSAGE, "%s.  New identifier %d is in use by %s outside group",
+							function_name, identifiers[j] + offset, Traits::objectName());
+						return_code = 0;
+						break;
+					}
+				}
+			}
+		}
+		if (return_code)
+		{
+			/* move to unused identifiers first so no new identifier is held by
+				an object still to be renumbered */
+			int temporaryIdentifier = identifiers[numberOfObjects - 1] + ((offset > 0) ? offset : 0);
+			iterator = Traits::createIterator(master);
+			while (0 != (object = Traits::next(iterator)))
+			{
+				const int identifier = Traits::getIdentifier(object);
+				if (identifier > temporaryIdentifier)
+					temporaryIdentifier = identifier;
+				Traits::destroy(&object);
+			}
+			Traits::destroyIterator(&iterator);
+			if ((long long)temporaryIdentifier + numberOfObjects > maximumIdentifier)
+			{
+				display_message(ERROR_MESSAGE, "%s.  Not enough unused %s identifiers above %d "
+					"to renumber %d %ss", function_name, Traits::objectName(), temporaryIdentifier,
+					numberOfObjects, Traits::objectName());
+				return_code = 0;
+			}
+			for (int j = 0; (j < numberOfObjects) && return_code; ++j)
+			{
+				++temporaryIdentifier;
+				if (CMZN_OK != Traits::setIdentifier(objects[points[j].index], temporaryIdentifier))
+					return_code = 0;
+			}
+			for (int j = 0; (j < numberOfObjects) && return_code; ++j)
+			{
+				if (CMZN_OK != Traits::setIdentifier(objects[points[j].index], identifiers[j] + offset))
+					return_code = 0;
+			}
+			if (!return_code)
+			{
+				display_message(ERROR_MESSAGE, "%s.  Failed to change %s identifiers",
+					function_name, Traits::objectName());
+			}
+		}
+		Traits::destroyDomain(&master);
+	}
+	for (int j = 0; j < numberOfObjects; ++j)
+		Traits::destroy(&(objects[j]));
+	cmzn_fieldmodule_destroy(&fieldmodule);
+	return return_code;
+}
+
+} // anonymous namespace
+
+int Space_filling_curve_type_from_string(const char *name,
+	enum Space_filling_curve_type *curve_type_address)
+{
+	if (name && curve_type_address)
+	{
+		if (fuzzy_string_compare_same_length(name, "hilbert"))
+		{
+			*curve_type_address = SPACE_FILLING_CURVE_HILBERT;
+			return 1;
+		}
+		if (fuzzy_string_compare_same_length(name, "morton"))
+		{
+			*curve_type_address = SPACE_FILLING_CURVE_MORTON;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+int set_Space_filling_curve_type(struct Parse_state *state,
+	void *curve_type_address_void, void *set_flag_address_void)
+{
+	enum Space_filling_curve_type *curve_type_address =
+		static_cast<enum Space_filling_curve_type *>(curve_type_address_void);
+	if (!(state && curve_type_address))
+	{
+		display_message(ERROR_MESSAGE,
+			"set_Space_filling_curve_type.  Invalid argument(s)");
+		return 0;
+	}
+	const char *current_token = state->current_token;
+	if (!current_token)
+	{
+		display_message(ERROR_MESSAGE, "Missing space filling curve order");
+		display_parse_state_location(state);
+		return 0;
+	}
+	if (strcmp(PARSER_HELP_STRING, current_token) &&
+		strcmp(PARSER_RECURSIVE_HELP_STRING, current_token))
+	{
+		if (!Space_filling_curve_type_from_string(current_token, curve_type_address))
+		{
+			display_message(ERROR_MESSAGE, "Invalid space filling curve order %s",
+				current_token);
+			display_parse_state_location(state);
+			return 0;
+		}
+		if (set_flag_address_void)
+			*(static_cast<char *>(set_flag_address_void)) = 1;
+		return shift_Parse_state(state, 1);
+	}
+	display_message(INFORMATION_MESSAGE, " hilbert|morton[%s]",
+		(*curve_type_address == SPACE_FILLING_CURVE_MORTON) ? "morton" : "hilbert");
+	return 1;
+}
+
+int cmzn_nodeset_get_field_range(cmzn_nodeset_id nodeset, cmzn_field_id field,
+	double time, double *minimums, double *maximums)
+{
+	int return_code = 0;
+	const int number_of_components = cmzn_field_get_number_of_components(field);
+	if (nodeset && (0 < number_of_components) && minimums && maximums)
+	{
+		cmzn_fieldmodule_id fieldmodule = cmzn_nodeset_get_fieldmodule(nodeset);
+		cmzn_fieldcache_id fieldcache = cmzn_fieldmodule_create_fieldcache(fieldmodule);
+		cmzn_fieldcache_set_time(fieldcache, time);
+		std::vector<double> values(number_of_components);
+		cmzn_nodeiterator_id iterator = cmzn_nodeset_create_nodeiterator(nodeset);
+		cmzn_node_id node;
+		while (0 != (node = cmzn_nodeiterator_next(iterator)))
+		{
+			cmzn_fieldcache_set_node(fieldcache, node);
+			if (CMZN_OK == cmzn_field_evaluate_real(field, fieldcache, number_of_components, values.data()))
+			{
+				for (int i = 0; i < number_of_components; ++i)
+				{
+					if ((!return_code) || (values[i] < minimums[i]))
+						minimums[i] = values[i];
+					if ((!return_code) || (values[i] > maximums[i]))
+						maximums[i] = values[i];
+				}
+				return_code = 1;
+			}
+			cmzn_node_destroy(&node);
+		}
+		cmzn_nodeiterator_destroy(&iterator);
+		cmzn_fieldcache_destroy(&fieldcache);
+		cmzn_fieldmodule_destroy(&fieldmodule);
+	}
+	return return_code;
+}
+
+int cmzn_nodeset_change_node_identifiers_space_filling_curve(
+	cmzn_nodeset_id nodeset, int offset, cmzn_field_id field, double time,
+	enum Space_filling_curve_type curve_type, const double *minimums,
+	const double *maximums)
+{
+	return changeIdentifiersSpaceFillingCurve<Node_renumber_traits>(nodeset,
+		offset, field, time, curve_type, minimums, maximums,
+		"cmzn_nodeset_change_node_identifiers_space_filling_curve");
+}
+
+int cmzn_mesh_change_element_identifiers_space_filling_curve(
+	cmzn_mesh_id mesh, int offset, cmzn_field_id field, double time,
+	enum Space_filling_curve_type curve_type, const double *minimums,
+	const double *maximums)
+{
+	return changeIdentifiersSpaceFillingCurve<Element_renumber_traits>(mesh,
+		offset, field, time, curve_type, minimums, maximums,
+		"cmzn_mesh_change_element_identifiers_space_filling_curve");
+}
@@ -0,0 +1,84 @@
+/**
+ * FILE : finite_element_renumber_app.hpp
+ *
+ * Renumbering of nodes and elements in space filling curve order.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#if !defined (FINITE_ELEMENT_RENUMBER_APP_HPP)
+#define FINITE_ELEMENT_RENUMBER_APP_HPP
+
+#include "opencmiss/zinc/types/elementid.h"
+#include "opencmiss/zinc/types/fieldid.h"
+#include "opencmiss/zinc/types/nodeid.h"
+
+struct Parse_state;
+
+enum Space_filling_curve_type
+{
+	SPACE_FILLING_CURVE_HILBERT,
+	SPACE_FILLING_CURVE_MORTON
+};
+
+/**
+ * Gets the space filling curve type from its name: hilbert or morton.
+ * @return  1 on success with type set, 0 if name not recognised.
+ */
+int Space_filling_curve_type_from_string(const char *name,
+	enum Space_filling_curve_type *curve_type_address);
+
+/**
+ * Modifier function setting the space filling curve type from the next token,
+ * hilbert or morton, which are listed in help with the current value.
+ * @param curve_type_address_void  Address of enum Space_filling_curve_type.
+ * @param set_flag_address_void  Optional address of char set to 1 when the
+ * type is parsed, so callers can tell if it was specified.
+ */
+int set_Space_filling_curve_type(struct Parse_state *state,
+	void *curve_type_address_void, void *set_flag_address_void);
+
+/**
+ * Gets the range of each component of field over the nodes of nodeset at
+ * which it is defined.
+ *
+ * @param minimums, maximums  Arrays to receive the range of each component;
+ * size must be at least the number of components of field.
+ * @return  1 if field is defined at one or more nodes, otherwise 0.
+ */
+int cmzn_nodeset_get_field_range(cmzn_nodeset_id nodeset, cmzn_field_id field,
+	double time, double *minimums, double *maximums);
+
+/**
+ * Reassigns the identifiers of the nodes in nodeset so that they increase in
+ * the order the nodes' values of field lie along a space filling curve over
+ * the box from minimums to maximums. The nodes keep the identifiers they
+ * had between them, plus offset. Nodes nearby in space end up with nearby
+ * identifiers, which keeps later traversals of them cache friendly.
+ *
+ * @param field  Field with 1 to 3 real components defined at all nodes.
+ * @param minimums, maximums  Box for the curve, eg. from
+ * cmzn_nodeset_get_field_range. If either is NULL the range of field over
+ * nodeset is used.
+ * @return  1 on success, 0 on failure with identifiers unchanged if the new
+ * identifiers would clash with nodes outside nodeset.
+ */
+int cmzn_nodeset_change_node_identifiers_space_filling_curve(
+	cmzn_nodeset_id nodeset, int offset, cmzn_field_id field, double time,
+	enum Space_filling_curve_type curve_type, const double *minimums,
+	const double *maximums);
+
+/**
+ * As for cmzn_nodeset_change_node_identifiers_space_filling_curve but for
+ * elements, placed on the curve by the value of field at their centre. Pass
+ * the same box as used for nodes so element order is consistent with theirs.
+ */
+int cmzn_mesh_change_element_identifiers_space_filling_curve(
+	cmzn_mesh_id mesh, int offset, cmzn_field_id field, double time,
+	enum Space_filling_curve_type curve_type, const double *minimums,
+	const double *maximums);
+
+#endif /* !defined (FINITE_ELEMENT_RENUMBER_APP_HPP) */
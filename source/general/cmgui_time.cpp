@@ -45,7 +45,24 @@ clock_t cmgui_times_win32(struct tms *buffer)
 	gettime = timeGetTime();
 	return gettime;
 }
-#else /* defined (WIN32_SYSTEM) */
-/* Declare something so that this file will compile */
-int dummy;
 #endif /* defined (WIN32_SYSTEM) */
+
+double cmgui_get_elapsed_seconds(const struct timeval *start_time,
+	const struct timeval *end_time)
+{
+	struct timeval current_time;
+	if (!end_time)
+	{
+		cmgui_gettimeofday(&current_time, (struct timezone *)0);
+		end_time = &current_time;
+	}
+	return (double)(end_time->tv_sec - start_time->tv_sec) +
+		1.0e-6*(double)(end_time->tv_usec - start_time->tv_usec);
+}
+
+double cmgui_get_wall_time_seconds(void)
+{
+	struct timeval timeofday;
+	cmgui_gettimeofday(&timeofday, (struct timezone *)0);
+	return ((double)timeofday.tv_sec + 1.0e-6*(double)timeofday.tv_usec);
+}
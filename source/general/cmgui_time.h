@@ -55,4 +55,16 @@ clock_t cmgui_times_win32(struct tms *buffer);
 #error "Need implementation of gettimeofday() and times() for this OS"
 #endif /* switch (OPERATING_SYSTEM) */
 
+/**
+ * Returns the seconds from start_time to end_time, both from
+ * cmgui_gettimeofday. If end_time is NULL the current time is used.
+ */
+double cmgui_get_elapsed_seconds(const struct timeval *start_time,
+	const struct timeval *end_time);
+
+/**
+ * Returns the current time of day in seconds, for measuring intervals.
+ */
+double cmgui_get_wall_time_seconds(void);
+
 #endif /* !defined (GENERAL_CMGUI_TIME_HPP) */
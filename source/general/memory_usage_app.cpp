@@ -0,0 +1,259 @@
+/**
+ * FILE : memory_usage_app.cpp
+ *
+ * Report of memory used by regions, scenes, textures and caches.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "configure/cmgui_configure.h"
+#include "opencmiss/zinc/field.h"
+#include "opencmiss/zinc/fieldcache.h"
+#include "opencmiss/zinc/fieldfiniteelement.h"
+#include "opencmiss/zinc/fieldimage.h"
+#include "opencmiss/zinc/fieldmodule.h"
+#include "opencmiss/zinc/graphics.h"
+#include "opencmiss/zinc/mesh.h"
+#include "opencmiss/zinc/node.h"
+#include "opencmiss/zinc/nodeset.h"
+#include "opencmiss/zinc/region.h"
+#include "opencmiss/zinc/scene.h"
+#include "general/debug.h"
+#include "general/message.h"
+#include "general/memory_usage_app.h"
+#include "graphics/texture.h"
+#include "image_processing/image_filter_app.h"
+
+namespace {
+
+struct Memory_usage_item
+{
+	std::string section;
+	std::string name;
+	std::string quantity;
+	double value;
+
+	Memory_usage_item(const char *sectionIn, const std::string &nameIn,
+		const char *quantityIn, double valueIn) :
+		section(sectionIn),
+		name(nameIn),
+		quantity(quantityIn),
+		value(valueIn)
+	{
+	}
+};
+
+typedef std::vector<Memory_usage_item> Memory_usage_items;
+
+#if defined (UNIX) && !defined (DARWIN)
+/**
+ * Gets the value in kilobytes of entry name from /proc/self/status.
+ */
+int Memory_usage_get_process_status_kilobytes(const char *name, double *kilobytes)
+{
+	FILE *file = fopen("/proc/self/status", "r");
+	if (!file)
+		return 0;
+	const size_t name_length = strlen(name);
+	char line[256];
+	int return_code = 0;
+	while (fgets(line, sizeof(line), file))
+	{
+		if ((0 == strncmp(line, name, name_length)) && (line[name_length] == ':'))
+		{
+			return_code = (1 == sscanf(line + name_length + 1, "%lf", kilobytes));
+			break;
+		}
+	}
+	fclose(file);
+	return return_code;
+}
+#endif /* defined (UNIX) && !defined (DARWIN) */
+
+void Memory_usage_add_nodeset(cmzn_fieldmodule_id fieldmodule,
+	enum cmzn_field_domain_type domain_type, const char *quantity,
+	const std::vector<cmzn_field_id> &fields, const std::string &path,
+	Memory_usage_items &items, double &value_bytes)
+{
+	cmzn_nodeset_id nodeset = cmzn_fieldmodule_find_nodeset_by_field_domain_type(
+		fieldmodule, domain_type);
+	const int size = cmzn_nodeset_get_size(nodeset);
+	items.push_back(Memory_usage_item("region", path, quantity, (double)size));
+	if ((0 < size) && (!fields.empty()))
+	{
+		cmzn_fieldcache_id fieldcache = cmzn_fieldmodule_create_fieldcache(fieldmodule);
+		cmzn_nodeiterator_id iter = cmzn_nodeset_create_nodeiterator(nodeset);
+		cmzn_node_id node;
+		while (0 != (node = cmzn_nodeiterator_next_non_access(iter)))
+		{
+			cmzn_fieldcache_set_node(fieldcache, node);
+			for (size_t f = 0; f < fields.size(); ++f)
+			{
+				if (cmzn_field_is_defined_at_location(fields[f], fieldcache))
+				{
+					value_bytes += (double)(sizeof(double)*
+						cmzn_field_get_number_of_components(fields[f]));
+				}
+			}
+		}
+		cmzn_nodeiterator_destroy(&iter);
+		cmzn_fieldcache_destroy(&fieldcache);
+	}
+	cmzn_nodeset_destroy(&nodeset);
+}
+
+void Memory_usage_add_region(cmzn_region_id region, Memory_usage_items &items)
+{
+	char *path_c = cmzn_region_get_path(region);
+	const std::string path(path_c ? path_c : "/");
+	DEALLOCATE(path_c);
+	cmzn_fieldmodule_id fieldmodule = cmzn_region_get_fieldmodule(region);
+	/* finite element fields store parameters at nodes; image fields hold texels */
+	std::vector<cmzn_field_id> finite_element_fields;
+	int number_of_fields = 0;
+	int number_of_textures = 0;
+	double texture_bytes = 0.0;
+	cmzn_fielditerator_id field_iter = cmzn_fieldmodule_create_fielditerator(fieldmodule);
+	cmzn_field_id field;
+	while (0 != (field = cmzn_fielditerator_next(field_iter)))
+	{
+		++number_of_fields;
+		cmzn_field_finite_element_id finite_element_field = cmzn_field_cast_finite_element(field);
+		if (finite_element_field &&
+			(CMZN_FIELD_VALUE_TYPE_REAL == cmzn_field_get_value_type(field)))
+		{
+			finite_element_fields.push_back(cmzn_field_access(field));
+		}
+		cmzn_field_finite_element_destroy(&finite_element_field);
+		cmzn_field_image_id image_field = cmzn_field_cast_image(field);
+		if (image_field)
+		{
+			struct Texture *texture = cmzn_field_image_get_texture(image_field);
+			int width = 0, height = 0, depth = 0;
+			if (texture && Texture_get_original_size(texture, &width, &height, &depth))
+			{
+				++number_of_textures;
+				texture_bytes += (double)width*(double)height*(double)depth*
+					(double)cmzn_field_get_number_of_components(field)*
+					(double)Texture_get_number_of_bytes_per_component(texture);
+			}
+			cmzn_field_image_destroy(&image_field);
+		}
+		cmzn_field_destroy(&field);
+	}
+	cmzn_fielditerator_destroy(&field_iter);
+	double node_value_bytes = 0.0;
+	Memory_usage_add_nodeset(fieldmodule, CMZN_FIELD_DOMAIN_TYPE_NODES, "nodes",
+		finite_element_fields, path, items, node_value_bytes);
+	Memory_usage_add_nodeset(fieldmodule, CMZN_FIELD_DOMAIN_TYPE_DATAPOINTS, "data_points",
+		finite_element_fields, path, items, node_value_bytes);
+	for (size_t f = 0; f < finite_element_fields.size(); ++f)
+		cmzn_field_destroy(&finite_element_fields[f]);
+	static const char *element_quantities[3] = { "lines", "faces", "elements_3d" };
+	for (int dimension = 1; dimension <= 3; ++dimension)
+	{
+		cmzn_mesh_id mesh = cmzn_fieldmodule_find_mesh_by_dimension(fieldmodule, dimension);
+		items.push_back(Memory_usage_item("region", path, element_quantities[dimension - 1],
+			(double)cmzn_mesh_get_size(mesh)));
+		cmzn_mesh_destroy(&mesh);
+	}
+	items.push_back(Memory_usage_item("region", path, "fields", (double)number_of_fields));
+	items.push_back(Memory_usage_item("region", path, "node_value_bytes", node_value_bytes));
+	cmzn_fieldmodule_destroy(&fieldmodule);
+	cmzn_scene_id scene = cmzn_region_get_scene(region);
+	int number_of_graphics = 0;
+	cmzn_graphics_id graphics = cmzn_scene_get_first_graphics(scene);
+	while (graphics)
+	{
+		++number_of_graphics;
+		cmzn_graphics_id next_graphics = cmzn_scene_get_next_graphics(scene, graphics);
+		cmzn_graphics_destroy(&graphics);
+		graphics = next_graphics;
+	}
+	cmzn_scene_destroy(&scene);
+	items.push_back(Memory_usage_item("scene", path, "graphics", (double)number_of_graphics));
+	if (0 < number_of_textures)
+	{
+		items.push_back(Memory_usage_item("texture", path, "textures", (double)number_of_textures));
+		items.push_back(Memory_usage_item("texture", path, "texel_bytes", texture_bytes));
+	}
+	cmzn_region_id child = cmzn_region_get_first_child(region);
+	while (child)
+	{
+		Memory_usage_add_region(child, items);
+		cmzn_region_reaccess_next_sibling(&child);
+	}
+}
+
+}
+
+int list_memory_usage(cmzn_region_id region, int csv)
+{
+	if (!region)
+	{
+		display_message(ERROR_MESSAGE, "list_memory_usage.  Invalid argument(s)");
+		return 0;
+	}
+	Memory_usage_items items;
+#if defined (UNIX) && !defined (DARWIN)
+	double kilobytes;
+	if (Memory_usage_get_process_status_kilobytes("VmRSS", &kilobytes))
+		items.push_back(Memory_usage_item("process", "", "resident_bytes", 1024.0*kilobytes));
+	if (Memory_usage_get_process_status_kilobytes("VmHWM", &kilobytes))
+		items.push_back(Memory_usage_item("process", "", "peak_resident_bytes", 1024.0*kilobytes));
+#endif /* defined (UNIX) && !defined (DARWIN) */
+	Memory_usage_add_region(region, items);
+	int number_of_entries;
+	unsigned long long number_of_bytes;
+	if (Image_filter_cache_get_usage(&number_of_entries, &number_of_bytes))
+	{
+		items.push_back(Memory_usage_item("image_filter_cache", "", "images", (double)number_of_entries));
+		items.push_back(Memory_usage_item("image_filter_cache", "", "disk_bytes", (double)number_of_bytes));
+	}
+	if (csv)
+	{
+		display_message(INFORMATION_MESSAGE, "section,name,quantity,value\n");
+		for (size_t i = 0; i < items.size(); ++i)
+		{
+			display_message(INFORMATION_MESSAGE, "%s,%s,%s,%.0f\n",
+				items[i].section.c_str(), items[i].name.c_str(),
+				items[i].quantity.c_str(), items[i].value);
+		}
+		return 1;
+	}
+	/* one line per section and name */
+	std::string line;
+	for (size_t i = 0; i < items.size(); ++i)
+	{
+		if ((0 == i) || (items[i].section != items[i - 1].section) ||
+			(items[i].name != items[i - 1].name))
+		{
+			if (0 < i)
+				display_message(INFORMATION_MESSAGE, "%s\n", line.c_str());
+			line = items[i].section;
+			if (!items[i].name.empty())
+				line += " " + items[i].name;
+			line += ":";
+		}
+		else
+		{
+			line += ",";
+		}
+		char value[64];
+		if (std::string::npos != items[i].quantity.find("bytes"))
+			sprintf(value, " %s = %.1f MB", items[i].quantity.c_str(), items[i].value/(1024.0*1024.0));
+		else
+			sprintf(value, " %s = %.0f", items[i].quantity.c_str(), items[i].value);
+		line += value;
+	}
+	if (!items.empty())
+		display_message(INFORMATION_MESSAGE, "%s\n", line.c_str());
+	return 1;
+}
@@ -0,0 +1,31 @@
+/**
+ * FILE : memory_usage_app.h
+ *
+ * Report of memory used by regions, scenes, textures and caches.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#if !defined (MEMORY_USAGE_APP_H)
+#define MEMORY_USAGE_APP_H
+
+#include "opencmiss/zinc/types/regionid.h"
+
+/**
+ * Lists the memory used by the process where the operating system reports
+ * it, and for region and all its subregions: the number of nodes, data
+ * points, elements and fields, the bytes of node field values (a lower
+ * bound, excluding derivatives, versions and element parameters), the
+ * number of graphics in its scene and the bytes of texels in its image
+ * fields. Also lists the disk use of the image filter cache.
+ *
+ * @param csv  If non-zero, output lines of SECTION,NAME,QUANTITY,VALUE
+ * instead of the readable report.
+ * @return  1 on success, 0 on failure.
+ */
+int list_memory_usage(cmzn_region_id region, int csv);
+
+#endif /* !defined (MEMORY_USAGE_APP_H) */
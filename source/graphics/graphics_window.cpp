@@ -29,6 +29,7 @@ interest and set scene_viewer values directly.
 #include "opencmiss/zinc/sceneviewer.h"
 #include "command/parser.h"
 #include "computed_field/computed_field_image.h"
+#include "general/cmgui_time.h"
 #include "general/debug.h"
 #include "general/geometry.h"
 #include "general/indexed_list_private.h"
@@ -113,6 +114,8 @@ Module constants
 
 
 #define TIME_STEP 0.1
+/* largest number of panes in any layout */
+#define GRAPHICS_WINDOW_MAXIMUM_PANES 4
 static const char *axis_name[7]={"??","x","y","z","-x","-y","-z"};
 
 /*
@@ -123,6 +126,22 @@ Module types
 class wxGraphicsWindow;
 #endif /* defined (WX_USER_INTERFACE) */
 
+struct Graphics_window_pane_redraw
+/*******************************************************************************
+DESCRIPTION :
+Redraw scheduling state and render statistics for one pane.
+==============================================================================*/
+{
+	/* set when the pane's scene_viewer has asked to be redrawn */
+	int pending;
+	/* milliseconds taken by the last render of the pane */
+	double render_time;
+	/* smoothed rate at which the pane has been redrawn */
+	double frames_per_second;
+	/* wall clock time in seconds at which the last render started */
+	double last_frame_time;
+}; /* struct Graphics_window_pane_redraw */
+
 struct Graphics_window
 /*******************************************************************************
 LAST MODIFIED : 8 September 2000
@@ -169,6 +188,14 @@ Contains information for a graphics window.
 	/* scene_viewers and their parameters: */
 	enum Graphics_window_layout_mode layout_mode;
 	struct Scene_viewer_app **scene_viewer_array;
+	/* all pane redraws requested before idle time are done in one pass */
+	struct Event_dispatcher_idle_callback *redraw_idle_callback_id;
+	struct Graphics_window_pane_redraw pane_redraw[GRAPHICS_WINDOW_MAXIMUM_PANES];
+	/* while printing a batch of views the scene is built once and the offscreen
+		 buffer for the first pane is kept for reuse by views of the same size */
+	int print_batch_active, print_batch_scene_built;
+	struct Graphics_buffer_app *print_batch_buffer;
+	int print_batch_buffer_width, print_batch_buffer_height;
 	/* The viewing_width and viewing_height are the size of the viewing area when
 		 the graphics window has only one pane. When multiple panes are used, they
 		 are separated by 2 pixel borders within the viewing area.
@@ -596,6 +623,112 @@ layout_modes, eg. GRAPHICS_WINDOW_LAYOUT_ORTHOGRAPHIC.
 	LEAVE;
 } /* Graphics_window_Scene_viewer_view_changed */
 
+static int Graphics_window_redraw_idle_callback(void *window_void)
+/*******************************************************************************
+DESCRIPTION :
+Redraws every pane of the window that has requested it since the last pass.
+Scene graphics changed since the last redraw are rebuilt while rendering the
+first pane and reused by the others, then each pane is made current, rendered
+and swapped in turn. Records render time and frame rate for each pane.
+==============================================================================*/
+{
+	struct Graphics_window *window = (struct Graphics_window *)window_void;
+	if (window)
+	{
+		/* set idle callback no longer pending */
+		window->redraw_idle_callback_id = 0;
+		if (window->scene_viewer_array)
+		{
+			for (int pane_no = 0; pane_no < window->number_of_scene_viewers; ++pane_no)
+			{
+				struct Graphics_window_pane_redraw *pane_redraw = &(window->pane_redraw[pane_no]);
+				if (pane_redraw->pending)
+				{
+					pane_redraw->pending = 0;
+					const double start_time = cmgui_get_wall_time_seconds();
+					const int tumbling = Scene_viewer_app_update_now(window->scene_viewer_array[pane_no]);
+					const double end_time = cmgui_get_wall_time_seconds();
+					pane_redraw->render_time = 1000.0*(end_time - start_time);
+					if (pane_redraw->last_frame_time > 0.0)
+					{
+						const double interval = start_time - pane_redraw->last_frame_time;
+						if (interval > 0.0)
+						{
+							if (pane_redraw->frames_per_second > 0.0)
+							{
+								pane_redraw->frames_per_second =
+									0.8*pane_redraw->frames_per_second + 0.2/interval;
+							}
+							else
+							{
+								pane_redraw->frames_per_second = 1.0/interval;
+							}
+						}
+					}
+					pane_redraw->last_frame_time = start_time;
+					if (tumbling)
+					{
+						Scene_viewer_app_redraw_in_idle_time(window->scene_viewer_array[pane_no]);
+					}
+				}
+			}
+		}
+	}
+	/* We don't want the idle callback to repeat so we return 0 */
+	return 0;
+}
+
+static int Graphics_window_Scene_viewer_redraw_request(
+	struct Scene_viewer_app *scene_viewer, void *window_void)
+/*******************************************************************************
+DESCRIPTION :
+Marks the pane showing <scene_viewer> for redraw and posts a single idle
+callback for the window if one is not already pending.
+==============================================================================*/
+{
+	struct Graphics_window *window = (struct Graphics_window *)window_void;
+	if (window && window->scene_viewer_array && scene_viewer)
+	{
+		for (int pane_no = 0; pane_no < window->number_of_scene_viewers; ++pane_no)
+		{
+			if (scene_viewer == window->scene_viewer_array[pane_no])
+			{
+				window->pane_redraw[pane_no].pending = 1;
+				if (!window->redraw_idle_callback_id)
+				{
+					window->redraw_idle_callback_id = Event_dispatcher_add_idle_callback(
+						User_interface_get_event_dispatcher(window->user_interface),
+						Graphics_window_redraw_idle_callback, (void *)window,
+						EVENT_DISPATCHER_IDLE_UPDATE_SCENE_VIEWER_PRIORITY);
+				}
+				return 1;
+			}
+		}
+	}
+	display_message(ERROR_MESSAGE,
+		"Graphics_window_Scene_viewer_redraw_request.  Invalid argument(s)");
+	return 0;
+}
+
+static void Graphics_window_cancel_scheduled_redraw(struct Graphics_window *window)
+/*******************************************************************************
+DESCRIPTION :
+Removes any pending window redraw, eg. before its scene_viewers are destroyed.
+==============================================================================*/
+{
+	if (window->redraw_idle_callback_id)
+	{
+		Event_dispatcher_remove_idle_callback(
+			User_interface_get_event_dispatcher(window->user_interface),
+			window->redraw_idle_callback_id);
+		window->redraw_idle_callback_id = 0;
+	}
+	for (int pane_no = 0; pane_no < GRAPHICS_WINDOW_MAXIMUM_PANES; ++pane_no)
+	{
+		window->pane_redraw[pane_no].pending = 0;
+	}
+}
+
 /*
 Command Parsing Module functions
 --------------------------------
@@ -1153,6 +1286,7 @@ public:
 			if (graphics_window->time_keeper_app)
 				graphics_window->time_keeper_app->removeCallback(Graphics_window_time_keeper_app_callback,
 					(void *)graphics_window);
+			Graphics_window_cancel_scheduled_redraw(graphics_window);
 			if (graphics_window->scene_viewer_array)
 			{
 				 /* close the Scene_viewer(s) */
@@ -3229,6 +3363,19 @@ it.
 			window->number_of_scene_viewers = 0;
 			window->number_of_panes=0;
 			window->scene_viewer_array = 0;
+			window->redraw_idle_callback_id = 0;
+			window->print_batch_active = 0;
+			window->print_batch_scene_built = 0;
+			window->print_batch_buffer = 0;
+			window->print_batch_buffer_width = 0;
+			window->print_batch_buffer_height = 0;
+			for (pane_no = 0; pane_no < GRAPHICS_WINDOW_MAXIMUM_PANES; ++pane_no)
+			{
+				window->pane_redraw[pane_no].pending = 0;
+				window->pane_redraw[pane_no].render_time = 0.0;
+				window->pane_redraw[pane_no].frames_per_second = 0.0;
+				window->pane_redraw[pane_no].last_frame_time = 0.0;
+			}
 			window->current_pane=0;
 			window->antialias_mode=0;
 			window->perturb_lines=0;
@@ -3325,6 +3472,10 @@ it.
 								window->scene_viewer_array[pane_no],
 								Graphics_window_Scene_viewer_view_changed,
 								window);
+							/* coalesce idle redraws of all panes into one pass */
+							Scene_viewer_app_set_redraw_request_function(
+								window->scene_viewer_array[pane_no],
+								Graphics_window_Scene_viewer_redraw_request, window);
 							cmzn_sceneviewer_set_translation_rate(
 								window->scene_viewer_array[pane_no], 2.0);
 							cmzn_sceneviewer_set_tumble_rate(
@@ -3461,6 +3612,10 @@ it.
 									window->scene_viewer_array[pane_no],
 									Graphics_window_Scene_viewer_view_changed,
 									window);
+								/* coalesce idle redraws of all panes into one pass */
+								Scene_viewer_app_set_redraw_request_function(
+									window->scene_viewer_array[pane_no],
+									Graphics_window_Scene_viewer_redraw_request, window);
 								cmzn_sceneviewer_set_translation_rate(
 									window->scene_viewer_array[pane_no], 2.0);
 								cmzn_sceneviewer_set_tumble_rate(
@@ -3686,6 +3841,10 @@ it.
 										 window->scene_viewer_array[pane_no],
 										 Graphics_window_Scene_viewer_view_changed,
 										 window);
+									/* coalesce idle redraws of all panes into one pass */
+									Scene_viewer_app_set_redraw_request_function(
+										 window->scene_viewer_array[pane_no],
+										 Graphics_window_Scene_viewer_redraw_request, window);
 									cmzn_sceneviewer_set_translation_rate(
 										 window->scene_viewer_array[pane_no]->core_scene_viewer, 2.0);
 									cmzn_sceneviewer_set_tumble_rate(
@@ -3835,6 +3994,10 @@ it.
 									window->scene_viewer_array[pane_no],
 									Graphics_window_Scene_viewer_view_changed,
 									window);
+								/* coalesce idle redraws of all panes into one pass */
+								Scene_viewer_app_set_redraw_request_function(
+									window->scene_viewer_array[pane_no],
+									Graphics_window_Scene_viewer_redraw_request, window);
 								cmzn_sceneviewer_set_translation_rate(
 									window->scene_viewer_array[pane_no], 2.0);
 								cmzn_sceneviewer_set_tumble_rate(
@@ -3915,6 +4078,8 @@ Graphics_window_destroy_CB.
 	ENTER(DESTROY(graphics_window));
 	if (graphics_window_address&&(window= *graphics_window_address))
 	{
+		Graphics_window_cancel_scheduled_redraw(window);
+		Graphics_window_end_print_batch(window);
 #if !defined (WX_USER_INTERFACE)
 		 /* the class wxGraphicsWindow destructor will handle the
 				destruction of the scene viewers. */
@@ -4483,6 +4648,10 @@ Sets the layout mode in effect on the <window>.
 								window->scene_viewer_array[pane_no],
 								Graphics_window_Scene_viewer_view_changed,
 								window);
+							/* coalesce idle redraws of all panes into one pass */
+							Scene_viewer_app_set_redraw_request_function(
+								window->scene_viewer_array[pane_no],
+								Graphics_window_Scene_viewer_redraw_request, window);
 							cmzn_sceneviewer_set_translation_rate(
 								pane_sceneviewer,
 								window->default_translate_rate);
@@ -5386,6 +5555,38 @@ the pixels out of the backbuffer before the frames are swapped.
 	return (return_code);
 } /* Graphics_window_update_now_without_swapbuffers */
 
+int Graphics_window_begin_print_batch(struct Graphics_window *window)
+{
+	if (!window)
+	{
+		display_message(ERROR_MESSAGE,
+			"Graphics_window_begin_print_batch.  Invalid argument(s)");
+		return 0;
+	}
+	Graphics_window_end_print_batch(window);
+	window->print_batch_active = 1;
+	return 1;
+}
+
+int Graphics_window_end_print_batch(struct Graphics_window *window)
+{
+	if (!window)
+	{
+		display_message(ERROR_MESSAGE,
+			"Graphics_window_end_print_batch.  Invalid argument(s)");
+		return 0;
+	}
+	if (window->print_batch_buffer)
+	{
+		DESTROY(Graphics_buffer_app)(&(window->print_batch_buffer));
+	}
+	window->print_batch_active = 0;
+	window->print_batch_scene_built = 0;
+	window->print_batch_buffer_width = 0;
+	window->print_batch_buffer_height = 0;
+	return 1;
+}
+
 int Graphics_window_get_frame_pixels(struct Graphics_window *window,
 	enum Texture_storage_type storage, int *width, int *height,
 	int preferred_antialias, int preferred_transparency_layers,
@@ -5434,9 +5635,17 @@ graphics window on screen.
 	if (window && width && height)
 	{
 		// force complete build of all graphics in scene for image output, otherwise may get only incremental output
-		cmzn_scenefilter_id filter = cmzn_sceneviewer_get_scenefilter((window->scene_viewer_array[0]->core_scene_viewer));
-		build_Scene(window->scene, filter);
-		cmzn_scenefilter_destroy(&filter);
+		// only changes of view are made between the frames of a print batch so build once
+		if (!(window->print_batch_active && window->print_batch_scene_built))
+		{
+			cmzn_scenefilter_id filter = cmzn_sceneviewer_get_scenefilter((window->scene_viewer_array[0]->core_scene_viewer));
+			build_Scene(window->scene, filter);
+			cmzn_scenefilter_destroy(&filter);
+			if (window->print_batch_active)
+			{
+				window->print_batch_scene_built = 1;
+			}
+		}
 
 		double frame_split_ration = 1.0;
 		Graphics_window_get_viewing_area_size(window, &panel_width,
@@ -5531,9 +5740,24 @@ graphics window on screen.
 				tiles_down = (int)ceil(fraction_down);
 			}
 
-			if (!(offscreen_buffer = create_Graphics_buffer_offscreen_from_buffer(
-				  tile_width, tile_height, /*buffer_to_match*/Scene_viewer_app_get_graphics_buffer(
-				  Graphics_window_get_Scene_viewer(window, 0)))))
+			if (window->print_batch_buffer &&
+				(window->print_batch_buffer_width == tile_width) &&
+				(window->print_batch_buffer_height == tile_height))
+			{
+				offscreen_buffer = window->print_batch_buffer;
+				window->print_batch_buffer = 0;
+			}
+			else
+			{
+				if (window->print_batch_buffer)
+				{
+					DESTROY(Graphics_buffer_app)(&(window->print_batch_buffer));
+				}
+				offscreen_buffer = create_Graphics_buffer_offscreen_from_buffer(
+					tile_width, tile_height, /*buffer_to_match*/Scene_viewer_app_get_graphics_buffer(
+					Graphics_window_get_Scene_viewer(window, 0)));
+			}
+			if (!offscreen_buffer)
 			{
 				force_onscreen = 1;
 			}
@@ -5735,7 +5959,16 @@ graphics window on screen.
 								original_viewport_left, original_viewport_top,
 								original_viewport_pixels_per_x, original_viewport_pixels_per_y);
 						}
-						DESTROY(Graphics_buffer_app)(&current_buffer);
+						if ((pane == 0) && window->print_batch_active)
+						{
+							window->print_batch_buffer = current_buffer;
+							window->print_batch_buffer_width = tile_width;
+							window->print_batch_buffer_height = tile_height;
+						}
+						else
+						{
+							DESTROY(Graphics_buffer_app)(&current_buffer);
+						}
 					}
 				}
 			}
@@ -6444,6 +6677,13 @@ Writes the properties of the <window> to the command window.
 		{
 			cmzn_sceneviewer *pane_sceneviewer = window->scene_viewer_array[pane_no]->core_scene_viewer;
 			display_message(INFORMATION_MESSAGE,"  pane: %d\n",pane_no+1);
+			if (pane_no < GRAPHICS_WINDOW_MAXIMUM_PANES)
+			{
+				display_message(INFORMATION_MESSAGE,
+					"    last render %g ms, %.1f frames per second\n",
+					window->pane_redraw[pane_no].render_time,
+					window->pane_redraw[pane_no].frames_per_second);
+			}
 			/* background */
 			double rgb[3];
 			cmzn_sceneviewer_get_background_colour_rgb(pane_sceneviewer, rgb);
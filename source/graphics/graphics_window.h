@@ -424,6 +424,21 @@ in the backbuffer so that utility functions such as the movie extensions can get
 the pixels out of the backbuffer before the frames are swapped.
 ==============================================================================*/
 
+int Graphics_window_begin_print_batch(struct Graphics_window *window);
+/*******************************************************************************
+DESCRIPTION :
+Starts a batch of offscreen frames of <window> which differ only in their view.
+Until Graphics_window_end_print_batch the scene is built for the first frame
+only and the offscreen buffer of the first pane is kept for reuse by following
+frames of the same tile size.
+==============================================================================*/
+
+int Graphics_window_end_print_batch(struct Graphics_window *window);
+/*******************************************************************************
+DESCRIPTION :
+Ends any print batch of <window>, freeing its kept offscreen buffer.
+==============================================================================*/
+
 int Graphics_window_get_frame_pixels(struct Graphics_window *window,
 	enum Texture_storage_type storage, int *width, int *height,
 	int preferred_antialias, int preferred_transparency_layers,
@@ -86,10 +86,14 @@ class wxCmguiHierachicalTreeItemData :public wxTreeItemData
 {
 	struct cmzn_region *region;
 	wxCmguiHierachicalTree *treectrl;
+	/* true once tree items have been created for the child regions. Children
+		are only added when the item is first expanded */
+	bool children_populated;
 
 public:
 	wxCmguiHierachicalTreeItemData(struct cmzn_region *input_region,
-		wxCmguiHierachicalTree *input_treectrl) : treectrl(input_treectrl)
+		wxCmguiHierachicalTree *input_treectrl) : treectrl(input_treectrl),
+		children_populated(false)
 	{
 		region = ACCESS(cmzn_region)(input_region);
 		treectrl = input_treectrl;
@@ -109,6 +113,16 @@ public:
 		return region;
 	}
 
+	bool AreChildrenPopulated() const
+	{
+		return children_populated;
+	}
+
+	void SetChildrenPopulated(bool populated)
+	{
+		children_populated = populated;
+	}
+
 	static void propagate_region_change(
 		struct cmzn_region *region, cmzn_region_changes *region_changes, void *data_void);
 };
@@ -128,6 +142,9 @@ public:
 		Connect(wxEVT_LEFT_DOWN,
 			wxMouseEventHandler(wxCmguiHierachicalTree::SendLeftDownEvent),
 			NULL,this);
+		Connect(wxEVT_COMMAND_TREE_ITEM_EXPANDING,
+			wxTreeEventHandler(wxCmguiHierachicalTree::OnItemExpanding),
+			NULL,this);
 	}
 
 	wxCmguiHierachicalTree()
@@ -145,18 +162,66 @@ public:
 		SetItemData(id, data);
 	}
 
+	wxCmguiHierachicalTreeItemData *GetRegionItemData(wxTreeItemId id)
+	{
+		return dynamic_cast<wxCmguiHierachicalTreeItemData *>(GetItemData(id));
+	}
+
+	static bool region_has_children(cmzn_region *region)
+	{
+		cmzn_region *child_region = cmzn_region_get_first_child(region);
+		if (child_region)
+		{
+			cmzn_region_destroy(&child_region);
+			return true;
+		}
+		return false;
+	}
+
+	/***************************************************************************//**
+	 * Create a tree item for <child_region> under <parent_id>, inserted at
+	 * <position> or appended if position is negative. The item's children are not
+	 * added until it is expanded; it only shows an expand button if the region
+	 * has children.
+	 */
+	wxTreeItemId add_region_item(wxTreeItemId parent_id, int position,
+		cmzn_region *child_region)
+	{
+		wxTreeItemId child_id;
+		char *child_name = cmzn_region_get_name(child_region);
+		if (child_name)
+		{
+			int image = 0;
+			cmzn_scene *scene = cmzn_region_get_scene(child_region);
+			if (scene)
+			{
+				image = cmzn_scene_get_visibility_flag(scene) ? 0 : 1;
+				cmzn_scene::deaccess(scene);
+			}
+			if (position < 0)
+				child_id = AppendItem(parent_id, wxString::FromAscii(child_name), image, image);
+			else
+				child_id = InsertItem(parent_id, position, wxString::FromAscii(child_name), image, image);
+			SetItemImage(child_id, image, wxTreeItemIcon_Expanded);
+			SetItemImage(child_id, image, wxTreeItemIcon_SelectedExpanded);
+			SetTreeIdRegionWithCallback(child_id, child_region);
+			SetItemHasChildren(child_id, region_has_children(child_region));
+			DEALLOCATE(child_name);
+		}
+		return child_id;
+	}
+
 	void remove_child_with_region(wxTreeItemId parent_id, cmzn_region *child_region)
 	{
 		wxTreeItemIdValue cookie;
 		wxTreeItemId child_id = GetFirstChild(parent_id, cookie);
-		cmzn_region *parent_region = dynamic_cast<wxCmguiHierachicalTreeItemData *>
-			(GetItemData(parent_id))->GetRegion();
+		cmzn_region *parent_region = GetRegionItemData(parent_id)->GetRegion();
 		while (child_id.IsOk())
 		{
 			/* if child_region is NULL then find an item with region that does not
 				belong to the parent region and remove it from the tree */
-			cmzn_region * current_region = dynamic_cast<wxCmguiHierachicalTreeItemData *>
-				(GetItemData(child_id))->GetRegion();
+			cmzn_region * current_region = GetRegionItemData(child_id)->GetRegion();
+			wxTreeItemId next_id = GetNextChild(parent_id, cookie);
 			if ((child_region && child_region == current_region)
 				|| (!child_region && !cmzn_region_contains_subregion(parent_region, current_region)))
 			{
@@ -164,49 +229,57 @@ public:
 					SelectItem(child_id, false);
 				Delete(child_id);
 			}
-			child_id = GetNextChild(parent_id, cookie);
+			child_id = next_id;
 		}
 	}
 
+	/***************************************************************************//**
+	 * Add items for any child regions of the item's region not already in the
+	 * tree, then update the subtrees of populated children only.
+	 */
 	void update_current_tree_item(wxTreeItemId parent_id)
 	{
+		wxCmguiHierachicalTreeItemData *parent_data = GetRegionItemData(parent_id);
+		cmzn_region *parent_region = parent_data->GetRegion();
+		if (!parent_data->AreChildrenPopulated())
+		{
+			SetItemHasChildren(parent_id, region_has_children(parent_region));
+			return;
+		}
 		int i = 0, return_code = 0;
-		cmzn_region *parent_region = dynamic_cast<wxCmguiHierachicalTreeItemData *>
-			(GetItemData(parent_id))->GetRegion();
-		char *child_name;
 		cmzn_region *child_region = NULL;
 		wxTreeItemIdValue cookie;
 		child_region = cmzn_region_get_first_child(parent_region);
 		while (child_region)
 		{
 			return_code = 0;
-			child_name = cmzn_region_get_name(child_region);
 			wxTreeItemId child_id = GetFirstChild(parent_id, cookie);
 			while (child_id.IsOk() && !return_code)
 			{
-				cmzn_region *current_region = dynamic_cast<wxCmguiHierachicalTreeItemData *>
-					(GetItemData(child_id))->GetRegion();
+				cmzn_region *current_region = GetRegionItemData(child_id)->GetRegion();
 				if (current_region == child_region)
 				{
 					return_code = 1;
 				}
-				child_id = GetNextChild(parent_id, cookie);
+				else
+				{
+					child_id = GetNextChild(parent_id, cookie);
+				}
 			}
 			if (!return_code)
 			{
-				child_id = InsertItem(parent_id, i, wxString::FromAscii(child_name),0,0);
-				SetTreeIdRegionWithCallback(child_id, child_region);
+				child_id = add_region_item(parent_id, i, child_region);
 				if (!(this->IsExpanded(parent_id)))
 					this->Expand(parent_id);
 			}
-			if (child_id.IsOk())
+			else if (child_id.IsOk())
 			{
 				update_current_tree_item(child_id);
 			}
-			DEALLOCATE(child_name);
 			cmzn_region_reaccess_next_sibling(&child_region);
 			i++;
 		}
+		SetItemHasChildren(parent_id, (i > 0));
 	}
 
 	void region_change(struct cmzn_region *region,
@@ -220,14 +293,15 @@ public:
 			{
 				const wxTreeItemId parent_id = data->GetId();
 				struct cmzn_region *child_region = NULL;
-				if (region_changes->child_added)
+				if (!data->AreChildrenPopulated())
+				{
+					/* children are added when the item is expanded */
+					SetItemHasChildren(parent_id, region_has_children(region));
+				}
+				else if (region_changes->child_added)
 				{
 					child_region = region_changes->child_added;
-					char *name = cmzn_region_get_name(child_region);
-					wxTreeItemId child_id = AppendItem(parent_id,wxString::FromAscii(name),0,0);
-					SetTreeIdRegionWithCallback(child_id, child_region);
-					update_current_tree_item(child_id);
-					DEALLOCATE(name);
+					add_region_item(parent_id, -1, child_region);
 					if (!(this->IsExpanded(parent_id)))
 						this->Expand(parent_id);
 				}
@@ -235,6 +309,7 @@ public:
 				{
 					child_region = region_changes->child_removed;
 					remove_child_with_region(parent_id, child_region);
+					SetItemHasChildren(parent_id, region_has_children(region));
 				}
 				else
 				{
@@ -251,33 +326,42 @@ public:
 		LEAVE;
 	}
 
-void add_all_child_regions_to_tree_item(wxTreeItemId parent_id)
+/***************************************************************************//**
+ * Add items for the immediate child regions of the item's region, if not
+ * already done. Grandchildren are added on demand when their parent item is
+ * expanded, so the cost of building the tree is proportional to the number of
+ * items the user has expanded rather than the size of the region hierarchy.
+ */
+void add_child_regions_to_tree_item(wxTreeItemId parent_id)
 {
-	char *child_name;
-	wxTreeItemId child_id;
-	cmzn_region *parent_region, *child_region;
-
-	parent_region = dynamic_cast<wxCmguiHierachicalTreeItemData *>
-		(GetItemData(parent_id))->GetRegion();
-	child_region = cmzn_region_get_first_child(parent_region);
+	wxCmguiHierachicalTreeItemData *parent_data = GetRegionItemData(parent_id);
+	if ((!parent_data) || parent_data->AreChildrenPopulated())
+		return;
+	parent_data->SetChildrenPopulated(true);
+	cmzn_region *child_region = cmzn_region_get_first_child(parent_data->GetRegion());
+	if (!child_region)
+	{
+		SetItemHasChildren(parent_id, false);
+		return;
+	}
+	Freeze();
 	while (child_region)
 	{
-		child_name = cmzn_region_get_name(child_region);
-		if (child_name)
-		{
-			child_id = AppendItem(parent_id,wxString::FromAscii(child_name),0,0);
-			SetTreeIdRegionWithCallback(child_id, child_region);
-			add_all_child_regions_to_tree_item(child_id);
-			DEALLOCATE(child_name);
-		}
+		add_region_item(parent_id, -1, child_region);
 		cmzn_region_reaccess_next_sibling(&child_region);
 	}
-	this->ExpandAll();
+	Thaw();
 }
 
 private:
 	void SendLeftDownEvent(wxMouseEvent& event);
 
+	void OnItemExpanding(wxTreeEvent& event)
+	{
+		add_child_regions_to_tree_item(event.GetItem());
+		event.Skip();
+	}
+
 // 	void SendRightDownEvent(wxMousEvent& event);
 
 	DECLARE_DYNAMIC_CLASS(wxCmguiHierachicalTree);
@@ -3651,8 +3735,35 @@ void SetVisibilityOfTreeId(wxTreeItemId current_item_id, bool flag)
 	}
 }
 
+/***************************************************************************//**
+ * Set visibility of scenes for all descendants of region which have no tree
+ * items yet.
+ */
+void PropagateChangesToSubregions(cmzn_region *region, bool flag)
+{
+	cmzn_region *child_region = cmzn_region_get_first_child(region);
+	while (child_region)
+	{
+		cmzn_scene *scene = cmzn_region_get_scene(child_region);
+		if (scene)
+		{
+			cmzn_scene_set_visibility_flag(scene, flag);
+			cmzn_scene::deaccess(scene);
+		}
+		PropagateChangesToSubregions(child_region, flag);
+		cmzn_region_reaccess_next_sibling(&child_region);
+	}
+}
+
 void PropagateChanges(wxTreeItemId current_item_id, bool flag)
 {
+	wxCmguiHierachicalTreeItemData* data =
+		region_tree_viewer->testing_tree_ctrl->GetRegionItemData(current_item_id);
+	if (!data->AreChildrenPopulated())
+	{
+		PropagateChangesToSubregions(data->GetRegion(), flag);
+		return;
+	}
 	wxTreeItemIdValue cookie;
 	wxTreeItemId child_id = region_tree_viewer->testing_tree_ctrl->GetFirstChild(
 		current_item_id, cookie);
@@ -4103,7 +4214,8 @@ void Region_tree_viewer_setup_region_tree(Region_tree_viewer *region_tree_viewer
 		current = region_tree_viewer->testing_tree_ctrl->AddRoot(wxString::FromAscii(root_region_path),0,0);
 		region_tree_viewer->testing_tree_ctrl->SetTreeIdRegionWithCallback(
 			current, region_tree_viewer->root_region);
-		region_tree_viewer->testing_tree_ctrl->add_all_child_regions_to_tree_item(current);
+		region_tree_viewer->testing_tree_ctrl->add_child_regions_to_tree_item(current);
+		region_tree_viewer->testing_tree_ctrl->Expand(current);
 		scene = cmzn_region_get_scene(region_tree_viewer->root_region);
 		cmzn_scene::reaccess(region_tree_viewer->scene, scene);
 		cmzn_scene::deaccess(scene);
@@ -4236,7 +4348,6 @@ DESCRIPTION :
 			region_tree_viewer->ImageList->Add(wxIcon(unticked_box_xpm));
 			region_tree_viewer->testing_tree_ctrl->AssignImageList(region_tree_viewer->ImageList);
 			Region_tree_viewer_setup_region_tree(region_tree_viewer);
-			region_tree_viewer->testing_tree_ctrl->ExpandAll();
 			tree_control_panel->Layout();
 		}
 		else
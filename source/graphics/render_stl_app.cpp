@@ -0,0 +1,207 @@
+/**
+ * FILE : render_stl_app.cpp
+ *
+ * Binary STL export of scene surfaces.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "opencmiss/zinc/scenefilter.h"
+#include "general/debug.h"
+#include "general/message.h"
+#include "graphics/render_triangularisation.hpp"
+#include "graphics/scene.hpp"
+#include "graphics/triangle_mesh.hpp"
+#include "graphics/render_stl_app.h"
+
+namespace {
+
+/* Binary STL: 80 byte header, little endian 32-bit triangle count, then per
+ * triangle 12 little endian 32-bit floats (normal, 3 vertices) and a 16-bit
+ * attribute byte count */
+const size_t STL_BINARY_HEADER_SIZE = 80;
+const size_t STL_BINARY_TRIANGLE_SIZE = 50;
+
+class Stl_binary_writer
+{
+	FILE *file;
+	std::vector<unsigned char> buffer;
+	size_t buffer_size;
+	int number_of_triangles;
+	unsigned long long number_of_bytes;
+	bool error;
+
+	void flush()
+	{
+		if (this->buffer_size > 0)
+		{
+			if (this->buffer_size != fwrite(&(this->buffer[0]), 1, this->buffer_size, this->file))
+				this->error = true;
+			this->number_of_bytes += this->buffer_size;
+			this->buffer_size = 0;
+		}
+	}
+
+	void add_uint32(unsigned int value)
+	{
+		unsigned char *bytes = &(this->buffer[this->buffer_size]);
+		bytes[0] = static_cast<unsigned char>(value & 0xff);
+		bytes[1] = static_cast<unsigned char>((value >> 8) & 0xff);
+		bytes[2] = static_cast<unsigned char>((value >> 16) & 0xff);
+		bytes[3] = static_cast<unsigned char>((value >> 24) & 0xff);
+		this->buffer_size += 4;
+	}
+
+	void add_float(float value)
+	{
+		unsigned int bits;
+		memcpy(&bits, &value, 4);
+		this->add_uint32(bits);
+	}
+
+public:
+
+	Stl_binary_writer(FILE *fileIn) :
+		file(fileIn),
+		buffer(STL_BINARY_TRIANGLE_SIZE*4096),
+		buffer_size(0),
+		number_of_triangles(0),
+		number_of_bytes(0),
+		error(false)
+	{
+		char header[STL_BINARY_HEADER_SIZE];
+		/* header must not start with "solid", which marks ASCII STL */
+		memset(header, ' ', STL_BINARY_HEADER_SIZE);
+		const char *title = "Binary STL exported by cmgui";
+		memcpy(header, title, strlen(title));
+		memcpy(&(this->buffer[0]), header, STL_BINARY_HEADER_SIZE);
+		this->buffer_size = STL_BINARY_HEADER_SIZE;
+		/* triangle count is written by finish() */
+		this->add_uint32(0);
+	}
+
+	void add_triangle(const float normal[3], const float vertices[3][3])
+	{
+		if (this->buffer_size + STL_BINARY_TRIANGLE_SIZE > this->buffer.size())
+			this->flush();
+		for (int i = 0; i < 3; ++i)
+			this->add_float(normal[i]);
+		for (int v = 0; v < 3; ++v)
+			for (int i = 0; i < 3; ++i)
+				this->add_float(vertices[v][i]);
+		/* attribute byte count */
+		this->buffer[this->buffer_size++] = 0;
+		this->buffer[this->buffer_size++] = 0;
+		++(this->number_of_triangles);
+	}
+
+	/** Writes remaining triangles and the triangle count.
+	 * @return  1 on success, 0 on failure */
+	int finish()
+	{
+		this->flush();
+		this->add_uint32(static_cast<unsigned int>(this->number_of_triangles));
+		if ((0 != fseek(this->file, static_cast<long>(STL_BINARY_HEADER_SIZE), SEEK_SET)) ||
+			(4 != fwrite(&(this->buffer[0]), 1, 4, this->file)))
+		{
+			this->error = true;
+		}
+		this->buffer_size = 0;
+		return this->error ? 0 : 1;
+	}
+
+	int get_number_of_triangles() const
+	{
+		return this->number_of_triangles;
+	}
+
+	unsigned long long get_number_of_bytes() const
+	{
+		return this->number_of_bytes;
+	}
+};
+
+}
+
+int export_to_binary_stl(const char *file_name, struct Scene *scene,
+	cmzn_scenefilter_id filter, int *number_of_triangles_address,
+	unsigned long long *number_of_bytes_address)
+{
+	if (!(file_name && scene))
+	{
+		display_message(ERROR_MESSAGE, "export_to_binary_stl.  Invalid argument(s)");
+		return 0;
+	}
+	build_Scene(scene, filter);
+	/* only merge coincident vertices, so coordinates are written unchanged */
+	Render_graphics_triangularisation renderer(NULL, /*tolerance*/0.0f);
+	if (!(renderer.Scene_compile(scene, filter) && renderer.Scene_tree_execute(scene)))
+	{
+		display_message(ERROR_MESSAGE,
+			"export_to_binary_stl.  Could not get triangles from scene");
+		return 0;
+	}
+	FILE *file = fopen(file_name, "wb");
+	if (!file)
+	{
+		display_message(ERROR_MESSAGE,
+			"export_to_binary_stl.  Could not create %s", file_name);
+		return 0;
+	}
+	int return_code = 1;
+	Stl_binary_writer writer(file);
+	Triangle_mesh *trimesh = renderer.get_triangle_mesh();
+	if (trimesh)
+	{
+		const Triangle_vertex *vertex[3];
+		double coordinates[3][3];
+		float normal[3], vertices[3][3];
+		/* reference the renderer's list: copying it would double peak memory */
+		const Mesh_triangle_list &triangle_list = trimesh->get_triangle_list();
+		for (Mesh_triangle_list_const_iterator triangle_iter = triangle_list.begin();
+			triangle_iter != triangle_list.end(); ++triangle_iter)
+		{
+			(*triangle_iter)->get_vertexes(&(vertex[0]), &(vertex[1]), &(vertex[2]));
+			for (int v = 0; v < 3; ++v)
+			{
+				vertex[v]->get_coordinates(coordinates[v]);
+				for (int i = 0; i < 3; ++i)
+					vertices[v][i] = static_cast<float>(coordinates[v][i]);
+			}
+			/* unit normal from the right hand rule on the vertex order */
+			double a[3], b[3], n[3];
+			for (int i = 0; i < 3; ++i)
+			{
+				a[i] = coordinates[1][i] - coordinates[0][i];
+				b[i] = coordinates[2][i] - coordinates[0][i];
+			}
+			n[0] = a[1]*b[2] - a[2]*b[1];
+			n[1] = a[2]*b[0] - a[0]*b[2];
+			n[2] = a[0]*b[1] - a[1]*b[0];
+			const double length = sqrt(n[0]*n[0] + n[1]*n[1] + n[2]*n[2]);
+			for (int i = 0; i < 3; ++i)
+				normal[i] = (length > 0.0) ? static_cast<float>(n[i]/length) : 0.0f;
+			writer.add_triangle(normal, vertices);
+		}
+	}
+	if (!writer.finish())
+	{
+		display_message(ERROR_MESSAGE,
+			"export_to_binary_stl.  Error writing %s", file_name);
+		return_code = 0;
+	}
+	if (0 != fclose(file))
+		return_code = 0;
+	if (number_of_triangles_address)
+		*number_of_triangles_address = writer.get_number_of_triangles();
+	if (number_of_bytes_address)
+		*number_of_bytes_address = writer.get_number_of_bytes();
+	return return_code;
+}
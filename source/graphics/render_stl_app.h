@@ -0,0 +1,38 @@
+/**
+ * FILE : render_stl_app.h
+ *
+ * Binary STL export of scene surfaces.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#if !defined (RENDER_STL_APP_H_)
+#define RENDER_STL_APP_H_
+
+#include "opencmiss/zinc/types/scenefilterid.h"
+
+struct Scene;
+
+/**
+ * Writes the surfaces of scene and its child scenes passing filter to a binary
+ * STL file. Triangles are collected from the scene's graphics with the
+ * triangularisation renderer used by gfx mesh graphics, then streamed from its
+ * triangle list through a buffered writer, so peak memory is that of the
+ * renderer's triangle mesh. As in ASCII STL each facet is written with its own
+ * three vertices; the mesh merges only exactly coincident vertices, so merging
+ * does not change the coordinates written. The normal is computed from the
+ * vertex order.
+ *
+ * @param number_of_triangles_address  Optional; receives the number of
+ * triangles written.
+ * @param number_of_bytes_address  Optional; receives the size of the file.
+ * @return  1 on success, 0 on failure.
+ */
+int export_to_binary_stl(const char *file_name, struct Scene *scene,
+	cmzn_scenefilter_id filter, int *number_of_triangles_address,
+	unsigned long long *number_of_bytes_address);
+
+#endif /* !defined (RENDER_STL_APP_H_) */
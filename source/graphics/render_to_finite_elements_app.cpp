@@ -4,10 +4,159 @@
 * License, v. 2.0. If a copy of the MPL was not distributed with this
 * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include <math.h>
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+#include "opencmiss/zinc/fieldcache.h"
+#include "opencmiss/zinc/fieldmodule.h"
+#include "opencmiss/zinc/status.h"
 #include "general/enumerator_private_app.h"
 #include "graphics/render_to_finite_elements_app.h"
 
 
 DEFINE_DEFAULT_OPTION_TABLE_ADD_ENUMERATOR_FUNCTION(Render_to_finite_elements_mode)
 
+namespace {
 
+/** Integer indices of a cube of side tolerance in a uniform grid */
+struct Spatial_hash_cell
+{
+	long index[3];
+
+	bool operator==(const Spatial_hash_cell &other) const
+	{
+		return (this->index[0] == other.index[0]) &&
+			(this->index[1] == other.index[1]) && (this->index[2] == other.index[2]);
+	}
+};
+
+struct Spatial_hash_cell_hash
+{
+	size_t operator()(const Spatial_hash_cell &cell) const
+	{
+		/* large primes spread neighbouring cells over the buckets */
+		return static_cast<size_t>(cell.index[0])*73856093u ^
+			static_cast<size_t>(cell.index[1])*19349663u ^
+			static_cast<size_t>(cell.index[2])*83492791u;
+	}
+};
+
+struct Spatial_hash_point
+{
+	double x[3];
+};
+
+/* points in each occupied grid cell, hashed on cell indices */
+typedef std::unordered_map<Spatial_hash_cell, std::vector<Spatial_hash_point>,
+	Spatial_hash_cell_hash> Spatial_hash;
+
+}
+
+int cmzn_nodeset_get_node_identifiers(cmzn_nodeset_id nodeset,
+	std::vector<int> &identifiers)
+{
+	if (!nodeset)
+		return 0;
+	identifiers.clear();
+	identifiers.reserve(cmzn_nodeset_get_size(nodeset));
+	cmzn_nodeiterator_id iterator = cmzn_nodeset_create_nodeiterator(nodeset);
+	cmzn_node_id node;
+	while (0 != (node = cmzn_nodeiterator_next_non_access(iterator)))
+		identifiers.push_back(cmzn_node_get_identifier(node));
+	cmzn_nodeiterator_destroy(&iterator);
+	std::sort(identifiers.begin(), identifiers.end());
+	return 1;
+}
+
+int cmzn_nodeset_merge_added_coincident_nodes(cmzn_nodeset_id nodeset,
+	cmzn_field_id coordinate_field, double time,
+	const std::vector<int> &existing_identifiers, double tolerance)
+{
+	const int number_of_components = cmzn_field_get_number_of_components(coordinate_field);
+	if (!(nodeset && (0 < number_of_components) && (number_of_components <= 3) &&
+		(0.0 < tolerance)))
+	{
+		display_message(ERROR_MESSAGE,
+			"cmzn_nodeset_merge_added_coincident_nodes.  Invalid argument(s)");
+		return -1;
+	}
+	cmzn_fieldmodule_id fieldmodule = cmzn_field_get_fieldmodule(coordinate_field);
+	cmzn_fieldcache_id fieldcache = cmzn_fieldmodule_create_fieldcache(fieldmodule);
+	cmzn_fieldcache_set_time(fieldcache, time);
+	const double tolerance_squared = tolerance*tolerance;
+	Spatial_hash spatial_hash;
+	std::vector<cmzn_node_id> coincident_nodes;
+	cmzn_nodeiterator_id iterator = cmzn_nodeset_create_nodeiterator(nodeset);
+	cmzn_node_id node;
+	/* existing nodes come first in the hash so added nodes merge with them */
+	for (int pass = 0; pass < 2; ++pass)
+	{
+		while (0 != (node = cmzn_nodeiterator_next_non_access(iterator)))
+		{
+			const bool existing = std::binary_search(existing_identifiers.begin(),
+				existing_identifiers.end(), cmzn_node_get_identifier(node));
+			if (existing != (0 == pass))
+				continue;
+			Spatial_hash_point point = { { 0.0, 0.0, 0.0 } };
+			cmzn_fieldcache_set_node(fieldcache, node);
+			if (CMZN_OK != cmzn_field_evaluate_real(coordinate_field, fieldcache,
+				number_of_components, point.x))
+				continue;
+			Spatial_hash_cell cell;
+			for (int i = 0; i < 3; ++i)
+				cell.index[i] = static_cast<long>(floor(point.x[i]/tolerance));
+			bool coincident = false;
+			if (!existing)
+			{
+				Spatial_hash_cell neighbour;
+				for (int i = -1; (i <= 1) && !coincident; ++i)
+				{
+					neighbour.index[0] = cell.index[0] + i;
+					for (int j = -1; (j <= 1) && !coincident; ++j)
+					{
+						neighbour.index[1] = cell.index[1] + j;
+						for (int k = -1; (k <= 1) && !coincident; ++k)
+						{
+							neighbour.index[2] = cell.index[2] + k;
+							Spatial_hash::const_iterator cell_iter = spatial_hash.find(neighbour);
+							if (cell_iter == spatial_hash.end())
+								continue;
+							const std::vector<Spatial_hash_point> &points = cell_iter->second;
+							for (size_t p = 0; p < points.size(); ++p)
+							{
+								const double dx = points[p].x[0] - point.x[0];
+								const double dy = points[p].x[1] - point.x[1];
+								const double dz = points[p].x[2] - point.x[2];
+								if (dx*dx + dy*dy + dz*dz <= tolerance_squared)
+								{
+									coincident = true;
+									break;
+								}
+							}
+						}
+					}
+				}
+			}
+			if (coincident)
+				coincident_nodes.push_back(cmzn_node_access(node));
+			else
+				spatial_hash[cell].push_back(point);
+		}
+		cmzn_nodeiterator_destroy(&iterator);
+		if (0 == pass)
+			iterator = cmzn_nodeset_create_nodeiterator(nodeset);
+	}
+	cmzn_fieldcache_destroy(&fieldcache);
+	int number_destroyed = 0;
+	cmzn_fieldmodule_begin_change(fieldmodule);
+	for (size_t i = 0; i < coincident_nodes.size(); ++i)
+	{
+		if (CMZN_OK == cmzn_nodeset_destroy_node(nodeset, coincident_nodes[i]))
+			++number_destroyed;
+		cmzn_node_destroy(&(coincident_nodes[i]));
+	}
+	cmzn_fieldmodule_end_change(fieldmodule);
+	cmzn_fieldmodule_destroy(&fieldmodule);
+	return number_destroyed;
+}
@@ -7,7 +7,10 @@
 #if !defined (RENDER_TO_FINITE_ELEMENTS_APP_H_)
 #define RENDER_TO_FINITE_ELEMENTS_APP_H_
 
+#include <vector>
 #include "opencmiss/zinc/region.h"
+#include "opencmiss/zinc/field.h"
+#include "opencmiss/zinc/node.h"
 #include "opencmiss/zinc/scene.h"
 #include "opencmiss/zinc/fieldgroup.h"
 #include "general/debug.h"
@@ -18,5 +21,28 @@
 
 PROTOTYPE_OPTION_TABLE_ADD_ENUMERATOR_FUNCTION( Render_to_finite_elements_mode );
 
+/**
+ * Gets the identifiers of the nodes in nodeset, so nodes added later can be
+ * told apart from them.
+ * @param identifiers  Vector to receive identifiers in increasing order.
+ * @return  1 on success, 0 on failure.
+ */
+int cmzn_nodeset_get_node_identifiers(cmzn_nodeset_id nodeset,
+	std::vector<int> &identifiers);
+
+/**
+ * Destroys nodes of nodeset added since existing_identifiers were obtained
+ * whose coordinates are within tolerance of those of another node, either
+ * existing or added earlier in identifier order. Nodes are binned in a
+ * spatial hash of cells of size tolerance so each is only compared with the
+ * nodes in neighbouring cells. Only call for nodes not used by elements.
+ *
+ * @param existing_identifiers  Sorted identifiers of nodes not to destroy.
+ * @return  Number of nodes destroyed, or -1 on failure.
+ */
+int cmzn_nodeset_merge_added_coincident_nodes(cmzn_nodeset_id nodeset,
+	cmzn_field_id coordinate_field, double time,
+	const std::vector<int> &existing_identifiers, double tolerance);
+
 #endif
 
@@ -0,0 +1,219 @@
+/**
+ * FILE : render_wavefront_app.cpp
+ *
+ * Time series export of scene graphics to Wavefront OBJ files.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "opencmiss/zinc/scenefilter.h"
+#include "general/debug.h"
+#include "general/message.h"
+#include "graphics/render_wavefront.h"
+#include "graphics/render_wavefront_app.h"
+#include "time/time_keeper_app.hpp"
+
+namespace {
+
+int Wavefront_read_file(const char *file_name, std::string &contents)
+{
+	FILE *file = fopen(file_name, "rb");
+	if (!file)
+		return 0;
+	contents.clear();
+	char buffer[65536];
+	size_t length;
+	while (0 < (length = fread(buffer, 1, sizeof(buffer), file)))
+		contents.append(buffer, length);
+	fclose(file);
+	return 1;
+}
+
+int Wavefront_write_file(const std::string &file_name, const std::string &header,
+	const std::string &contents)
+{
+	FILE *file = fopen(file_name.c_str(), "wb");
+	if (!file)
+		return 0;
+	int return_code = (header.size() == fwrite(header.data(), 1, header.size(), file)) &&
+		(contents.size() == fwrite(contents.data(), 1, contents.size(), file));
+	if (0 != fclose(file))
+		return_code = 0;
+	return return_code;
+}
+
+/** @return  frame numbers as a comma separated list of ranges, eg. "2-4, 7". */
+std::string Wavefront_frame_list_string(const std::vector<int> &frames)
+{
+	std::string list;
+	char range[64];
+	size_t i = 0;
+	while (i < frames.size())
+	{
+		size_t j = i;
+		while ((j + 1 < frames.size()) && (frames[j + 1] == frames[j] + 1))
+			++j;
+		if (j > i)
+			sprintf(range, "%s%d-%d", list.empty() ? "" : ", ", frames[i], frames[j]);
+		else
+			sprintf(range, "%s%d", list.empty() ? "" : ", ", frames[i]);
+		list += range;
+		i = j + 1;
+	}
+	return list;
+}
+
+/**
+ * Splits OBJ file contents into its vertex, normal and texture coordinate
+ * lines and the remaining topology lines: faces, lines, groups and materials.
+ * Comments are dropped.
+ */
+void Wavefront_split_vertex_data(const std::string &contents,
+	std::string &vertex_data, std::string &topology)
+{
+	vertex_data.clear();
+	topology.clear();
+	size_t line_start = 0;
+	const size_t size = contents.size();
+	while (line_start < size)
+	{
+		size_t line_end = contents.find('\n', line_start);
+		line_end = (line_end == std::string::npos) ? size : line_end + 1;
+		const char *line = contents.data() + line_start;
+		const size_t length = line_end - line_start;
+		if ((length > 1) && (line[0] == 'v') &&
+			((line[1] == ' ') || (line[1] == 'n') || (line[1] == 't')))
+		{
+			vertex_data.append(line, length);
+		}
+		else if ((length > 0) && (line[0] != '#'))
+		{
+			topology.append(line, length);
+		}
+		line_start = line_end;
+	}
+}
+
+}
+
+int export_to_wavefront_time_series(const char *file_name, struct Scene *scene,
+	cmzn_scenefilter_id filter, int full_comments, struct Time_keeper_app *time_keeper_app,
+	double start_time, double end_time, int number_of_frames)
+{
+	if (!(file_name && scene && time_keeper_app && (0 < number_of_frames)))
+	{
+		display_message(ERROR_MESSAGE,
+			"export_to_wavefront_time_series.  Invalid argument(s)");
+		return 0;
+	}
+	std::string base_name(file_name);
+	const size_t extension_length = strlen(".obj");
+	if ((base_name.size() > extension_length) &&
+		(0 == base_name.compare(base_name.size() - extension_length, extension_length, ".obj")))
+	{
+		base_name.erase(base_name.size() - extension_length);
+	}
+	const double original_time = time_keeper_app->getTimeKeeper()->getTime();
+	/* export_to_wavefront can only write a named file, so every frame is
+		 exported to one scratch file and read back. Full frames are renamed into
+		 place; other frames write only their vertex lines, if anything. */
+	const std::string scratch_file_name = base_name + "_frame.tmp";
+	std::string contents, vertex_data, topology, reference_topology, previous_vertex_data;
+	std::vector<int> unchanged_frames, failed_frames;
+	int frames_written = 0, frames_full = 0;
+	/* last frame written in full, whose faces later vertex frames use */
+	int reference_frame = -1;
+	for (int frame = 0; frame < number_of_frames; ++frame)
+	{
+		const double time = (1 < number_of_frames) ?
+			start_time + (end_time - start_time)*(double)frame/(double)(number_of_frames - 1) :
+			start_time;
+		time_keeper_app->requestNewTime(time);
+		std::string frame_file_name(file_name);
+		if (0 < frame)
+		{
+			char frame_suffix[32];
+			sprintf(frame_suffix, "_%04d.obj", frame);
+			frame_file_name = base_name + frame_suffix;
+		}
+		if (!(export_to_wavefront(const_cast<char *>(scratch_file_name.c_str()),
+				scene, filter, full_comments) &&
+			Wavefront_read_file(scratch_file_name.c_str(), contents)))
+		{
+			display_message(ERROR_MESSAGE,
+				"gfx export wavefront:  Could not export frame %d at time %g",
+				frame, time);
+			failed_frames.push_back(frame);
+			continue;
+		}
+		Wavefront_split_vertex_data(contents, vertex_data, topology);
+		if ((reference_frame < 0) || (topology != reference_topology))
+		{
+			/* rename fails on some platforms if the target exists */
+			remove(frame_file_name.c_str());
+			if (0 != rename(scratch_file_name.c_str(), frame_file_name.c_str()))
+			{
+				display_message(ERROR_MESSAGE,
+					"gfx export wavefront:  Could not write frame %d to %s",
+					frame, frame_file_name.c_str());
+				failed_frames.push_back(frame);
+				continue;
+			}
+			reference_topology.swap(topology);
+			reference_frame = frame;
+			++frames_full;
+		}
+		else if (vertex_data == previous_vertex_data)
+		{
+			/* topology is also that of the previous frame, the reference */
+			unchanged_frames.push_back(frame);
+		}
+		else
+		{
+			char header[256];
+			sprintf(header, "# vertices for frame %d at time %g; faces are in frame %d\n",
+				frame, time, reference_frame);
+			if (Wavefront_write_file(frame_file_name, std::string(header), vertex_data))
+			{
+				++frames_written;
+			}
+			else
+			{
+				display_message(ERROR_MESSAGE,
+					"gfx export wavefront:  Could not write frame %d to %s",
+					frame, frame_file_name.c_str());
+				remove(frame_file_name.c_str());
+				failed_frames.push_back(frame);
+				continue;
+			}
+		}
+		previous_vertex_data.swap(vertex_data);
+	}
+	remove(scratch_file_name.c_str());
+	time_keeper_app->requestNewTime(original_time);
+	display_message(INFORMATION_MESSAGE,
+		"gfx export wavefront:  %d frames: %d written in full, %d vertices only, "
+		"%d unchanged, %d failed\n", number_of_frames, frames_full, frames_written,
+		static_cast<int>(unchanged_frames.size()), static_cast<int>(failed_frames.size()));
+	if (!unchanged_frames.empty())
+	{
+		display_message(INFORMATION_MESSAGE,
+			"  No files for unchanged frames %s; use the previous frame's file\n",
+			Wavefront_frame_list_string(unchanged_frames).c_str());
+	}
+	if (!failed_frames.empty())
+	{
+		display_message(ERROR_MESSAGE,
+			"gfx export wavefront:  No files for failed frames %s",
+			Wavefront_frame_list_string(failed_frames).c_str());
+		return 0;
+	}
+	return 1;
+}
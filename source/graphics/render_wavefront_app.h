@@ -0,0 +1,42 @@
+/**
+ * FILE : render_wavefront_app.h
+ *
+ * Time series export of scene graphics to Wavefront OBJ files.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#if !defined (RENDER_WAVEFRONT_APP_H_)
+#define RENDER_WAVEFRONT_APP_H_
+
+#include "opencmiss/zinc/types/scenefilterid.h"
+
+struct Scene;
+struct Time_keeper_app;
+
+/**
+ * Exports scene graphics passing filter to Wavefront OBJ at number_of_frames
+ * times evenly spaced from start_time to end_time, setting the time of
+ * time_keeper_app for each and restoring it afterwards.
+ * The first frame is written in full to file_name. Later frames with the same
+ * faces, groups and materials as the last frame written in full are written
+ * to <file_name base>_<frame>.obj containing only their vertex, normal and
+ * texture coordinate lines, and are not written at all if those are unchanged
+ * from the previous frame. Frames with different topology are written in full
+ * to the same frame file name and are used by later vertex-only frames.
+ * Each frame is exported to <file_name base>_frame.tmp and read back to
+ * compare it.
+ * Frames that fail are skipped and the export continues. Frame numbers with
+ * no file, because they are unchanged or failed, are listed at the end.
+ *
+ * @param file_name  Name of the first frame's file ending in .obj.
+ * @return  1 on success, 0 if any frame failed.
+ */
+int export_to_wavefront_time_series(const char *file_name, struct Scene *scene,
+	cmzn_scenefilter_id filter, int full_comments, struct Time_keeper_app *time_keeper_app,
+	double start_time, double end_time, int number_of_frames);
+
+#endif /* !defined (RENDER_WAVEFRONT_APP_H_) */
@@ -4,14 +4,21 @@
 * License, v. 2.0. If a copy of the MPL was not distributed with this
 * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include <map>
+#include <string>
+#include <vector>
+#include "opencmiss/zinc/fieldmodule.h"
 #include "opencmiss/zinc/glyph.h"
 #include "opencmiss/zinc/material.h"
 #include "opencmiss/zinc/mesh.h"
 #include "opencmiss/zinc/nodeset.h"
+#include "opencmiss/zinc/scenefilter.h"
+#include "opencmiss/zinc/spectrum.h"
 #include "opencmiss/zinc/status.h"
 #include "opencmiss/zinc/stream.h"
 #include "opencmiss/zinc/streamscene.h"
 #include "opencmiss/zinc/tessellation.h"
+#include "opencmiss/zinc/timekeeper.h"
 #include "general/debug.h"
 #include "general/enumerator_private_app.h"
 #include "general/message.h"
@@ -32,6 +39,7 @@
 #include "graphics/graphics_app.h"
 #include "general/enumerator_private.hpp"
 #include "graphics/scene_app.h"
+#include "region/cmiss_region.hpp"
 #include "region/cmiss_region_app.h"
 #include "user_interface/user_interface.h"
 
@@ -972,3 +980,431 @@ int cmzn_scene_set_graphics_defaults_gfx_modify(struct cmzn_scene *scene,
 	}
 	return return_code;
 }
+
+/**
+ * Cache of spectrum data ranges at individual times for one scene tree, filter
+ * and spectrum. Ranges are discarded when fields change in any region of the
+ * scene tree, when the graphics, region tree or tessellations differ from when
+ * they were computed, but not when only the time or spectrum settings change.
+ * The graphics and region tree are only compared after a scene or region
+ * change callback, so lookups without intervening changes are cheap.
+ * The filter and spectrum are identified by name and not accessed, so they
+ * can be destroyed. Regions and scenes in the tree are accessed while watched;
+ * those removed from the tree are released from the region change callback,
+ * and all are released when the cache is used for another scene or destroyed.
+ */
+struct Spectrum_autorange_cache
+{
+	struct Watched_region
+	{
+		/* accessed */
+		cmzn_region *region;
+		/* accessed if change callback added, otherwise NULL */
+		cmzn_scene_id scene;
+		cmzn_fieldmodulenotifier_id fieldmodulenotifier;
+	};
+
+	/* regions in the scene tree with callbacks; the first is its root */
+	std::vector<Watched_region> watched_regions;
+	std::string filter_name;
+	std::string spectrum_name;
+	int valuesCount;
+	/* description of regions and graphics in the scene tree ranges are valid for */
+	std::string signature;
+	/* description of the tessellations ranges are valid for */
+	std::string tessellation_signature;
+	/* set by scene and region change callbacks: signature must be compared */
+	bool changed;
+	/* set while changing time to evaluate ranges, when scene changes are ignored */
+	bool evaluating;
+	/* map from time to number of ranges, valuesCount minimums, valuesCount maximums */
+	std::map<double, std::vector<double> > time_ranges;
+	int hit_count, miss_count;
+
+	Spectrum_autorange_cache() :
+		valuesCount(0),
+		changed(false),
+		evaluating(false),
+		hit_count(0),
+		miss_count(0)
+	{
+	}
+
+	~Spectrum_autorange_cache()
+	{
+		clear();
+	}
+
+	void unwatch_region(Watched_region &watched_region)
+	{
+		if (watched_region.fieldmodulenotifier)
+		{
+			cmzn_fieldmodulenotifier_clear_callback(watched_region.fieldmodulenotifier);
+			cmzn_fieldmodulenotifier_destroy(&watched_region.fieldmodulenotifier);
+		}
+		if (watched_region.scene)
+		{
+			cmzn_scene_remove_callback(watched_region.scene, scene_change_callback,
+				static_cast<void *>(this));
+			cmzn_scene_destroy(&watched_region.scene);
+		}
+		cmzn_region_remove_callback(watched_region.region, region_change_callback,
+			static_cast<void *>(this));
+		cmzn_region_destroy(&watched_region.region);
+	}
+
+	void unwatch()
+	{
+		for (size_t i = 0; i < watched_regions.size(); ++i)
+			unwatch_region(watched_regions[i]);
+		watched_regions.clear();
+		changed = false;
+	}
+
+	/** Releases regions no longer in the tree under the root region. Called
+	 * from the change callback of a region, which remains in the tree */
+	void unwatch_removed_regions()
+	{
+		if (watched_regions.empty())
+			return;
+		cmzn_region *root_region = watched_regions[0].region;
+		size_t keep = 1;
+		for (size_t i = 1; i < watched_regions.size(); ++i)
+		{
+			if (cmzn_region_contains_subregion(root_region, watched_regions[i].region))
+				watched_regions[keep++] = watched_regions[i];
+			else
+				unwatch_region(watched_regions[i]);
+		}
+		watched_regions.resize(keep);
+	}
+
+	void clear()
+	{
+		unwatch();
+		time_ranges.clear();
+		signature.clear();
+		tessellation_signature.clear();
+		filter_name.clear();
+		spectrum_name.clear();
+		valuesCount = 0;
+	}
+
+	static void fieldmoduleevent_callback(cmzn_fieldmoduleevent_id event,
+		void *cache_void)
+	{
+		Spectrum_autorange_cache *cache = static_cast<Spectrum_autorange_cache *>(cache_void);
+		if (event && cache && (cmzn_fieldmoduleevent_get_summary_field_change_flags(event) &
+			(CMZN_FIELD_CHANGE_FLAG_ADD | CMZN_FIELD_CHANGE_FLAG_REMOVE |
+				CMZN_FIELD_CHANGE_FLAG_DEFINITION | CMZN_FIELD_CHANGE_FLAG_RESULT)))
+		{
+			cache->time_ranges.clear();
+		}
+	}
+
+	static int scene_change_callback(cmzn_scene *scene, void *cache_void)
+	{
+		USE_PARAMETER(scene);
+		Spectrum_autorange_cache *cache = static_cast<Spectrum_autorange_cache *>(cache_void);
+		if (cache && !cache->evaluating)
+			cache->changed = true;
+		return 1;
+	}
+
+	static void region_change_callback(cmzn_region *region,
+		cmzn_region_changes *region_changes, void *cache_void)
+	{
+		USE_PARAMETER(region);
+		Spectrum_autorange_cache *cache = static_cast<Spectrum_autorange_cache *>(cache_void);
+		if (cache)
+		{
+			cache->changed = true;
+			if (region_changes && region_changes->children_changed)
+				cache->unwatch_removed_regions();
+		}
+	}
+
+	/** Append names of region and graphics in its scene to signature, recursively */
+	static void append_region_signature(cmzn_region *region, std::string &signature)
+	{
+		char *name = cmzn_region_get_name(region);
+		signature += "region ";
+		if (name)
+		{
+			signature += name;
+			DEALLOCATE(name);
+		}
+		signature += "\n";
+		cmzn_scene_id scene = cmzn_region_get_scene(region);
+		if (scene)
+		{
+			if (!cmzn_scene_get_visibility_flag(scene))
+				signature += "invisible\n";
+			cmzn_graphics_id graphics = cmzn_scene_get_first_graphics(scene);
+			while (graphics)
+			{
+				char *graphics_string = cmzn_graphics_string(graphics,
+					GRAPHICS_STRING_COMPLETE_PLUS);
+				if (graphics_string)
+				{
+					signature += graphics_string;
+					DEALLOCATE(graphics_string);
+				}
+				signature += cmzn_graphics_get_visibility_flag(graphics) ? "\n" : " invisible\n";
+				cmzn_graphics_id ref_graphics = graphics;
+				graphics = cmzn_scene_get_next_graphics(scene, ref_graphics);
+				cmzn_graphics_destroy(&ref_graphics);
+			}
+			cmzn_scene_destroy(&scene);
+		}
+		cmzn_region *child_region = cmzn_region_get_first_child(region);
+		while (child_region)
+		{
+			append_region_signature(child_region, signature);
+			cmzn_region_reaccess_next_sibling(&child_region);
+		}
+		signature += "end\n";
+	}
+
+	/** Append name and divisions of every tessellation, which graphics are
+	 * built with, to signature. Tessellation changes do not notify scenes. */
+	static void append_tessellation_signature(cmzn_scene_id scene, std::string &signature)
+	{
+		cmzn_tessellationmodule_id tessellationmodule =
+			cmzn_graphics_module_get_tessellationmodule(scene->graphics_module);
+		cmzn_tessellationiterator_id iter =
+			cmzn_tessellationmodule_create_tessellationiterator(tessellationmodule);
+		cmzn_tessellation_id tessellation;
+		char number_string[32];
+		while (0 != (tessellation = cmzn_tessellationiterator_next(iter)))
+		{
+			char *name = cmzn_tessellation_get_name(tessellation);
+			if (name)
+			{
+				signature += name;
+				DEALLOCATE(name);
+			}
+			std::vector<int> divisions(cmzn_tessellation_get_minimum_divisions(tessellation, 0, 0));
+			if (!divisions.empty())
+				cmzn_tessellation_get_minimum_divisions(tessellation,
+					static_cast<int>(divisions.size()), &(divisions[0]));
+			std::vector<int> factors(cmzn_tessellation_get_refinement_factors(tessellation, 0, 0));
+			if (!factors.empty())
+				cmzn_tessellation_get_refinement_factors(tessellation,
+					static_cast<int>(factors.size()), &(factors[0]));
+			signature += " divisions";
+			for (size_t i = 0; i < divisions.size(); ++i)
+			{
+				sprintf(number_string, " %d", divisions[i]);
+				signature += number_string;
+			}
+			signature += " factors";
+			for (size_t i = 0; i < factors.size(); ++i)
+			{
+				sprintf(number_string, " %d", factors[i]);
+				signature += number_string;
+			}
+			sprintf(number_string, " circle %d\n", cmzn_tessellation_get_circle_divisions(tessellation));
+			signature += number_string;
+			cmzn_tessellation_destroy(&tessellation);
+		}
+		cmzn_tessellationiterator_destroy(&iter);
+		cmzn_tessellationmodule_destroy(&tessellationmodule);
+	}
+
+	/** Add field module notifiers and region and scene change callbacks for
+	 * region and all its descendants */
+	void watch_region_tree(cmzn_region *region)
+	{
+		if (cmzn_region_add_callback(region, region_change_callback, static_cast<void *>(this)))
+		{
+			Watched_region watched_region;
+			watched_region.region = cmzn_region_access(region);
+			watched_region.scene = cmzn_region_get_scene(region);
+			if (watched_region.scene && !cmzn_scene_add_callback(watched_region.scene,
+				scene_change_callback, static_cast<void *>(this)))
+			{
+				cmzn_scene_destroy(&watched_region.scene);
+			}
+			cmzn_fieldmodule_id fieldmodule = cmzn_region_get_fieldmodule(region);
+			watched_region.fieldmodulenotifier = cmzn_fieldmodule_create_fieldmodulenotifier(fieldmodule);
+			if (watched_region.fieldmodulenotifier)
+			{
+				cmzn_fieldmodulenotifier_set_callback(watched_region.fieldmodulenotifier,
+					fieldmoduleevent_callback, static_cast<void *>(this));
+			}
+			cmzn_fieldmodule_destroy(&fieldmodule);
+			watched_regions.push_back(watched_region);
+		}
+		cmzn_region *child_region = cmzn_region_get_first_child(region);
+		while (child_region)
+		{
+			watch_region_tree(child_region);
+			cmzn_region_reaccess_next_sibling(&child_region);
+		}
+	}
+
+	/**
+	 * Make cache valid for the supplied scene, filter, spectrum and number of
+	 * values, discarding cached ranges if any of these, the graphics in the
+	 * scene tree or the tessellations have changed.
+	 */
+	void update(cmzn_scene_id scene_in, cmzn_scenefilter_id filter_in,
+		cmzn_spectrum_id spectrum_in, int valuesCount_in)
+	{
+		cmzn_region *region = cmzn_scene_get_region_internal(scene_in);
+		std::string filter_name_in, spectrum_name_in, tessellation_signature_in;
+		char *name = filter_in ? cmzn_scenefilter_get_name(filter_in) : 0;
+		if (name)
+		{
+			filter_name_in = name;
+			DEALLOCATE(name);
+		}
+		name = cmzn_spectrum_get_name(spectrum_in);
+		if (name)
+		{
+			spectrum_name_in = name;
+			DEALLOCATE(name);
+		}
+		append_tessellation_signature(scene_in, tessellation_signature_in);
+		if (watched_regions.empty() || (region != watched_regions[0].region) ||
+			(filter_name_in != filter_name) || (spectrum_name_in != spectrum_name) ||
+			(valuesCount_in != valuesCount))
+		{
+			clear();
+			filter_name = filter_name_in;
+			spectrum_name = spectrum_name_in;
+			valuesCount = valuesCount_in;
+			tessellation_signature = tessellation_signature_in;
+			append_region_signature(region, signature);
+			watch_region_tree(region);
+			return;
+		}
+		if (tessellation_signature_in != tessellation_signature)
+		{
+			time_ranges.clear();
+			tessellation_signature = tessellation_signature_in;
+		}
+		if (changed)
+		{
+			std::string new_signature;
+			append_region_signature(region, new_signature);
+			if (new_signature != signature)
+			{
+				time_ranges.clear();
+				signature = new_signature;
+			}
+			/* regions may have been added or removed */
+			unwatch();
+			watch_region_tree(region);
+		}
+	}
+
+}; /* struct Spectrum_autorange_cache */
+
+struct Spectrum_autorange_cache *CREATE(Spectrum_autorange_cache)(void)
+{
+	return new Spectrum_autorange_cache();
+}
+
+int DESTROY(Spectrum_autorange_cache)(
+	struct Spectrum_autorange_cache **cache_address)
+{
+	if (cache_address && (*cache_address))
+	{
+		delete *cache_address;
+		*cache_address = 0;
+		return 1;
+	}
+	return 0;
+}
+
+int Spectrum_autorange_cache_get_statistics(
+	struct Spectrum_autorange_cache *cache, int *hit_count, int *miss_count)
+{
+	if (cache && hit_count && miss_count)
+	{
+		*hit_count = cache->hit_count;
+		*miss_count = cache->miss_count;
+		return 1;
+	}
+	return 0;
+}
+
+int cmzn_scene_get_spectrum_data_range_over_time(cmzn_scene_id scene,
+	cmzn_scenefilter_id filter, cmzn_spectrum_id spectrum,
+	cmzn_timekeeper_id timekeeper, double minimum_time, double maximum_time,
+	int number_of_times, struct Spectrum_autorange_cache *cache,
+	int valuesCount, double *minimumValuesOut, double *maximumValuesOut)
+{
+	if (!(scene && spectrum && timekeeper && (0 < number_of_times) &&
+		(0 < valuesCount) && minimumValuesOut && maximumValuesOut))
+	{
+		display_message(ERROR_MESSAGE,
+			"cmzn_scene_get_spectrum_data_range_over_time.  Invalid argument(s)");
+		return 0;
+	}
+	if (cache)
+		cache->update(scene, filter, spectrum, valuesCount);
+	if (cache)
+		cache->evaluating = true;
+	const double original_time = cmzn_timekeeper_get_time(timekeeper);
+	bool time_changed = false;
+	std::vector<double> time_minimums(valuesCount), time_maximums(valuesCount);
+	int maxRanges = 0;
+	for (int t = 0; t < number_of_times; ++t)
+	{
+		const double time = (1 == number_of_times) ? minimum_time :
+			minimum_time + (maximum_time - minimum_time)*(double)t/(double)(number_of_times - 1);
+		int timeRanges = 0;
+		std::map<double, std::vector<double> >::iterator iter;
+		if (cache && ((iter = cache->time_ranges.find(time)) != cache->time_ranges.end()))
+		{
+			const std::vector<double> &ranges = iter->second;
+			timeRanges = static_cast<int>(ranges[0]);
+			for (int i = 0; i < valuesCount; ++i)
+			{
+				time_minimums[i] = ranges[1 + i];
+				time_maximums[i] = ranges[1 + valuesCount + i];
+			}
+			++(cache->hit_count);
+		}
+		else
+		{
+			if (time != cmzn_timekeeper_get_time(timekeeper))
+			{
+				cmzn_timekeeper_set_time(timekeeper, time);
+				time_changed = true;
+			}
+			timeRanges = cmzn_scene_get_spectrum_data_range(scene, filter, spectrum,
+				valuesCount, time_minimums.data(), time_maximums.data());
+			if (cache)
+			{
+				std::vector<double> &ranges = cache->time_ranges[time];
+				ranges.resize(1 + 2*valuesCount);
+				ranges[0] = static_cast<double>(timeRanges);
+				for (int i = 0; i < valuesCount; ++i)
+				{
+					ranges[1 + i] = time_minimums[i];
+					ranges[1 + valuesCount + i] = time_maximums[i];
+				}
+				++(cache->miss_count);
+			}
+		}
+		const int valuesRanged = (timeRanges < valuesCount) ? timeRanges : valuesCount;
+		for (int i = 0; i < valuesRanged; ++i)
+		{
+			if ((i >= maxRanges) || (time_minimums[i] < minimumValuesOut[i]))
+				minimumValuesOut[i] = time_minimums[i];
+			if ((i >= maxRanges) || (time_maximums[i] > maximumValuesOut[i]))
+				maximumValuesOut[i] = time_maximums[i];
+		}
+		if (timeRanges > maxRanges)
+			maxRanges = timeRanges;
+	}
+	if (time_changed)
+		cmzn_timekeeper_set_time(timekeeper, original_time);
+	if (cache)
+		cache->evaluating = false;
+	return maxRanges;
+}
@@ -8,6 +8,7 @@
 #if !defined (SCENE_APP_H_)
 #define SCENE_APP_H_
 
+#include "opencmiss/zinc/types/timekeeperid.h"
 #include "general/enumerator_app.h"
 /**
  * Subset of command data passed to scene modify routines.
@@ -136,4 +137,36 @@ PROTOTYPE_OPTION_TABLE_ADD_ENUMERATOR_FUNCTION( cmzn_streaminformation_scene_io_
 int cmzn_scene_set_graphics_defaults_gfx_modify(struct cmzn_scene *scene,
 	struct cmzn_graphics *graphics);
 
+struct Spectrum_autorange_cache;
+
+struct Spectrum_autorange_cache *CREATE(Spectrum_autorange_cache)(void);
+
+int DESTROY(Spectrum_autorange_cache)(
+	struct Spectrum_autorange_cache **cache_address);
+
+/**
+ * Get the number of cached time ranges reused and computed by
+ * cmzn_scene_get_spectrum_data_range_over_time with this cache.
+ */
+int Spectrum_autorange_cache_get_statistics(
+	struct Spectrum_autorange_cache *cache, int *hit_count, int *miss_count);
+
+/**
+ * Get the range of data values displayed with spectrum in graphics of scene
+ * and its descendants, over number_of_times equally spaced times from
+ * minimum_time to maximum_time inclusive. Works as for
+ * cmzn_scene_get_spectrum_data_range but sets the time on timekeeper to each
+ * time in turn, restoring its original time afterwards.
+ * @param cache  Optional cache of ranges at individual times. Cached ranges are
+ * reused until fields or graphics in the scene tree, or tessellations, change.
+ * The cache accesses regions and scenes in the tree until it is used for
+ * another scene or destroyed; it does not access filter or spectrum.
+ * @return  Maximum number of ranges/components found at any time, or 0 if none.
+ */
+int cmzn_scene_get_spectrum_data_range_over_time(cmzn_scene_id scene,
+	cmzn_scenefilter_id filter, cmzn_spectrum_id spectrum,
+	cmzn_timekeeper_id timekeeper, double minimum_time, double maximum_time,
+	int number_of_times, struct Spectrum_autorange_cache *cache,
+	int valuesCount, double *minimumValuesOut, double *maximumValuesOut);
+
 #endif
@@ -0,0 +1,550 @@
+/**
+ * FILE : scene_transformation_table_app.cpp
+ *
+ * Tables of scene transformations over time, applied on time changes.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "opencmiss/zinc/region.h"
+#include "opencmiss/zinc/scene.h"
+#include "general/cmgui_time.h"
+#include "general/debug.h"
+#include "general/message.h"
+#include "graphics/scene.hpp"
+#include "graphics/scene_transformation_table_app.h"
+#include "time/time_keeper_app.hpp"
+
+namespace {
+
+const char SCENE_TRANSFORMATION_TABLE_MAGIC[] = "CMTRANS1";
+const size_t SCENE_TRANSFORMATION_TABLE_MAGIC_SIZE = 8;
+
+/**
+ * Transformations of one region's scene, with matrices stored contiguously
+ * 16 per time in increasing time order.
+ */
+struct Scene_transformation_track
+{
+	std::string path;
+	cmzn_scene *scene;
+	std::vector<double> times;
+	std::vector<double> matrices;
+	/* index of the matrix last set on scene, or -1 if none */
+	int applied_index;
+};
+
+struct Scene_transformation_sample
+{
+	double time;
+	double matrix[16];
+
+	bool operator<(const Scene_transformation_sample &other) const
+	{
+		return this->time < other.time;
+	}
+};
+
+typedef std::map<std::string, std::vector<Scene_transformation_sample> >
+	Scene_transformation_samples;
+
+/**
+ * Reads the binary table after the magic characters. Counts are checked
+ * against the bytes remaining in the file before anything is allocated, so a
+ * corrupt or hostile count fails instead of overflowing or exhausting memory.
+ */
+int Scene_transformation_table_read_binary(FILE *file,
+	Scene_transformation_samples &samples)
+{
+	long position = ftell(file);
+	if ((position < 0) || (0 != fseek(file, 0, SEEK_END)))
+		return 0;
+	long file_size = ftell(file);
+	if ((file_size < position) || (0 != fseek(file, position, SEEK_SET)))
+		return 0;
+	size_t remaining_bytes = static_cast<size_t>(file_size - position);
+	int number_of_regions;
+	if ((1 != fread(&number_of_regions, sizeof(int), 1, file)) || (number_of_regions < 0))
+		return 0;
+	remaining_bytes -= sizeof(int);
+	/* each region has at least a path length and a number of times */
+	if (static_cast<size_t>(number_of_regions) > remaining_bytes/(2*sizeof(int)))
+		return 0;
+	for (int r = 0; r < number_of_regions; ++r)
+	{
+		int path_length, number_of_times;
+		if ((1 != fread(&path_length, sizeof(int), 1, file)) || (path_length < 0))
+			return 0;
+		remaining_bytes -= sizeof(int);
+		if (static_cast<size_t>(path_length) + sizeof(int) > remaining_bytes)
+			return 0;
+		std::string path(path_length, '\0');
+		if ((0 < path_length) &&
+			((size_t)path_length != fread(&path[0], 1, path_length, file)))
+			return 0;
+		remaining_bytes -= path_length;
+		if ((1 != fread(&number_of_times, sizeof(int), 1, file)) || (number_of_times < 0))
+			return 0;
+		remaining_bytes -= sizeof(int);
+		/* one time and 16 matrix values per time */
+		const size_t number_of_values = static_cast<size_t>(number_of_times);
+		if (number_of_values > remaining_bytes/(17*sizeof(double)))
+			return 0;
+		std::vector<double> times(number_of_values);
+		std::vector<double> matrices(16*number_of_values);
+		if ((0 < number_of_values) &&
+			((number_of_values != fread(&times[0], sizeof(double), number_of_values, file)) ||
+			(16*number_of_values != fread(&matrices[0], sizeof(double), 16*number_of_values, file))))
+			return 0;
+		remaining_bytes -= 17*sizeof(double)*number_of_values;
+		std::vector<Scene_transformation_sample> &region_samples = samples[path];
+		for (int t = 0; t < number_of_times; ++t)
+		{
+			Scene_transformation_sample sample;
+			sample.time = times[t];
+			memcpy(sample.matrix, &matrices[16*t], 16*sizeof(double));
+			region_samples.push_back(sample);
+		}
+	}
+	return 1;
+}
+
+int Scene_transformation_table_read_text(FILE *file, const char *file_name,
+	Scene_transformation_samples &samples)
+{
+	std::vector<char> line(4096);
+	int line_number = 0;
+	while (fgets(&line[0], static_cast<int>(line.size()), file))
+	{
+		size_t length = strlen(&line[0]);
+		/* extend buffer for long lines */
+		while ((length == line.size() - 1) && (line[length - 1] != '\n'))
+		{
+			line.resize(2*line.size());
+			if (!fgets(&line[length], static_cast<int>(line.size() - length), file))
+				break;
+			length += strlen(&line[length]);
+		}
+		++line_number;
+		for (size_t i = 0; i < length; ++i)
+			if (line[i] == ',')
+				line[i] = ' ';
+		char *text = &line[0];
+		while ((*text == ' ') || (*text == '\t'))
+			++text;
+		if ((*text == '\0') || (*text == '\n') || (*text == '\r') || (*text == '#'))
+			continue;
+		char *path = text;
+		while (*text && (*text != ' ') && (*text != '\t') && (*text != '\n') && (*text != '\r'))
+			++text;
+		if (*text)
+			*(text++) = '\0';
+		Scene_transformation_sample sample;
+		char *end;
+		sample.time = strtod(text, &end);
+		if (end == text)
+		{
+			/* header line */
+			if (1 == line_number)
+				continue;
+			display_message(ERROR_MESSAGE,
+				"Scene_transformation_table_read_file.  Missing time on line %d of %s",
+				line_number, file_name);
+			return 0;
+		}
+		for (int i = 0; i < 16; ++i)
+		{
+			text = end;
+			sample.matrix[i] = strtod(text, &end);
+			if (end == text)
+			{
+				display_message(ERROR_MESSAGE,
+					"Scene_transformation_table_read_file.  Expected 16 matrix values on line %d of %s",
+					line_number, file_name);
+				return 0;
+			}
+		}
+		samples[std::string(path)].push_back(sample);
+	}
+	return 1;
+}
+
+}
+
+struct Scene_transformation_table
+{
+	cmzn_region_id root_region;
+	struct Time_keeper_app *time_keeper_app;
+	std::vector<Scene_transformation_track> tracks;
+	/* accessed ancestors of track regions with change callbacks, to find
+		 tracks whose regions have been removed from the tree */
+	std::set<cmzn_region_id> watched_regions;
+	int number_of_updates;
+	int number_of_scene_changes;
+	double update_time;
+	double maximum_update_time;
+
+	static void regionChange(struct cmzn_region *region,
+		cmzn_region_changes *region_changes, void *table_void)
+	{
+		USE_PARAMETER(region);
+		if (region_changes && region_changes->children_changed)
+			static_cast<Scene_transformation_table *>(table_void)->removeDetachedTracks();
+	}
+
+	void watch(cmzn_region_id region)
+	{
+		if (this->watched_regions.find(region) != this->watched_regions.end())
+			return;
+		cmzn_region_add_callback(region, Scene_transformation_table::regionChange, (void *)this);
+		this->watched_regions.insert(cmzn_region_access(region));
+	}
+
+	void unwatch(cmzn_region_id region)
+	{
+		cmzn_region_remove_callback(region, Scene_transformation_table::regionChange, (void *)this);
+		cmzn_region_destroy(&region);
+	}
+
+	/** Watches the root region and ancestors of every track's region */
+	void watchTrackRegions()
+	{
+		for (size_t i = 0; i < this->tracks.size(); ++i)
+		{
+			cmzn_region_id region = cmzn_region_get_parent(
+				cmzn_scene_get_region_internal(this->tracks[i].scene));
+			while (region)
+			{
+				this->watch(region);
+				if (region == this->root_region)
+				{
+					cmzn_region_destroy(&region);
+					break;
+				}
+				cmzn_region_id parent = cmzn_region_get_parent(region);
+				cmzn_region_destroy(&region);
+				region = parent;
+			}
+		}
+	}
+
+	/**
+	 * Releases tracks and watched regions no longer within the root region.
+	 * Called from the change callback of a region, which is still in the tree.
+	 * Tracks are not restored if a region is added again at the same path.
+	 */
+	void removeDetachedTracks();
+
+	void clear()
+	{
+		for (std::set<cmzn_region_id>::iterator iter = this->watched_regions.begin();
+			iter != this->watched_regions.end(); ++iter)
+		{
+			this->unwatch(*iter);
+		}
+		this->watched_regions.clear();
+		for (size_t i = 0; i < this->tracks.size(); ++i)
+			cmzn_scene_destroy(&(this->tracks[i].scene));
+		this->tracks.clear();
+		this->number_of_updates = 0;
+		this->number_of_scene_changes = 0;
+		this->update_time = 0.0;
+		this->maximum_update_time = 0.0;
+	}
+};
+
+namespace {
+
+int Scene_transformation_table_time_keeper_app_callback(
+	struct Time_keeper_app *time_keeper_app, enum Time_keeper_app_event event,
+	void *table_void)
+{
+	USE_PARAMETER(event);
+	struct Scene_transformation_table *table =
+		static_cast<struct Scene_transformation_table *>(table_void);
+	if (!(time_keeper_app && table))
+		return 0;
+	return Scene_transformation_table_apply(table,
+		time_keeper_app->getTimeKeeper()->getTime());
+}
+
+}
+
+void Scene_transformation_table::removeDetachedTracks()
+{
+	if (this->tracks.empty())
+		return;
+	size_t number_of_tracks = 0;
+	for (size_t i = 0; i < this->tracks.size(); ++i)
+	{
+		if (cmzn_region_contains_subregion(this->root_region,
+			cmzn_scene_get_region_internal(this->tracks[i].scene)))
+		{
+			this->tracks[number_of_tracks++] = this->tracks[i];
+		}
+		else
+		{
+			cmzn_scene_destroy(&(this->tracks[i].scene));
+		}
+	}
+	if (number_of_tracks == this->tracks.size())
+		return;
+	this->tracks.resize(number_of_tracks);
+	std::set<cmzn_region_id>::iterator iter = this->watched_regions.begin();
+	while (iter != this->watched_regions.end())
+	{
+		if (cmzn_region_contains_subregion(this->root_region, *iter))
+			++iter;
+		else
+		{
+			this->unwatch(*iter);
+			this->watched_regions.erase(iter++);
+		}
+	}
+	if (this->tracks.empty())
+	{
+		this->time_keeper_app->removeCallback(
+			Scene_transformation_table_time_keeper_app_callback, (void *)this);
+	}
+}
+
+struct Scene_transformation_table *CREATE(Scene_transformation_table)(
+	cmzn_region_id root_region, struct Time_keeper_app *time_keeper_app)
+{
+	if (!(root_region && time_keeper_app))
+	{
+		display_message(ERROR_MESSAGE,
+			"CREATE(Scene_transformation_table).  Invalid argument(s)");
+		return 0;
+	}
+	struct Scene_transformation_table *table = new Scene_transformation_table();
+	table->root_region = cmzn_region_access(root_region);
+	table->time_keeper_app = ACCESS(Time_keeper_app)(time_keeper_app);
+	table->number_of_updates = 0;
+	table->number_of_scene_changes = 0;
+	table->update_time = 0.0;
+	table->maximum_update_time = 0.0;
+	return table;
+}
+
+int DESTROY(Scene_transformation_table)(
+	struct Scene_transformation_table **table_address)
+{
+	if (!(table_address && (*table_address)))
+		return 0;
+	struct Scene_transformation_table *table = *table_address;
+	if (!table->tracks.empty())
+	{
+		table->time_keeper_app->removeCallback(
+			Scene_transformation_table_time_keeper_app_callback, (void *)table);
+	}
+	table->clear();
+	DEACCESS(Time_keeper_app)(&table->time_keeper_app);
+	cmzn_region_destroy(&table->root_region);
+	delete table;
+	*table_address = 0;
+	return 1;
+}
+
+int Scene_transformation_table_read_file(
+	struct Scene_transformation_table *table, const char *file_name)
+{
+	if (!(table && file_name))
+	{
+		display_message(ERROR_MESSAGE,
+			"Scene_transformation_table_read_file.  Invalid argument(s)");
+		return 0;
+	}
+	FILE *file = fopen(file_name, "rb");
+	if (!file)
+	{
+		display_message(ERROR_MESSAGE,
+			"Scene_transformation_table_read_file.  Could not open %s", file_name);
+		return 0;
+	}
+	Scene_transformation_samples samples;
+	char magic[SCENE_TRANSFORMATION_TABLE_MAGIC_SIZE];
+	int return_code;
+	if ((SCENE_TRANSFORMATION_TABLE_MAGIC_SIZE == fread(magic, 1, SCENE_TRANSFORMATION_TABLE_MAGIC_SIZE, file)) &&
+		(0 == memcmp(magic, SCENE_TRANSFORMATION_TABLE_MAGIC, SCENE_TRANSFORMATION_TABLE_MAGIC_SIZE)))
+	{
+		return_code = Scene_transformation_table_read_binary(file, samples);
+		if (!return_code)
+		{
+			display_message(ERROR_MESSAGE,
+				"Scene_transformation_table_read_file.  Truncated or invalid binary file %s", file_name);
+		}
+	}
+	else
+	{
+		rewind(file);
+		return_code = Scene_transformation_table_read_text(file, file_name, samples);
+	}
+	fclose(file);
+	if (!return_code)
+		return 0;
+	std::vector<Scene_transformation_track> tracks;
+	int number_of_samples = 0;
+	for (Scene_transformation_samples::iterator iter = samples.begin();
+		iter != samples.end(); ++iter)
+	{
+		cmzn_region_id region = cmzn_region_find_subregion_at_path(table->root_region,
+			iter->first.c_str());
+		if (!region)
+		{
+			display_message(WARNING_MESSAGE,
+				"Scene_transformation_table_read_file.  Ignoring transformations for unknown region %s",
+				iter->first.c_str());
+			continue;
+		}
+		std::vector<Scene_transformation_sample> &region_samples = iter->second;
+		std::stable_sort(region_samples.begin(), region_samples.end());
+		Scene_transformation_track track;
+		track.path = iter->first;
+		track.scene = cmzn_region_get_scene(region);
+		track.applied_index = -1;
+		const size_t number_of_times = region_samples.size();
+		track.times.resize(number_of_times);
+		track.matrices.resize(16*number_of_times);
+		for (size_t t = 0; t < number_of_times; ++t)
+		{
+			track.times[t] = region_samples[t].time;
+			memcpy(&track.matrices[16*t], region_samples[t].matrix, 16*sizeof(double));
+		}
+		number_of_samples += static_cast<int>(number_of_times);
+		tracks.push_back(track);
+		cmzn_region_destroy(&region);
+	}
+	const bool had_tracks = !table->tracks.empty();
+	table->clear();
+	table->tracks.swap(tracks);
+	table->watchTrackRegions();
+	if (had_tracks && table->tracks.empty())
+	{
+		table->time_keeper_app->removeCallback(
+			Scene_transformation_table_time_keeper_app_callback, (void *)table);
+	}
+	else if (!had_tracks && !table->tracks.empty())
+	{
+		table->time_keeper_app->addCallback(
+			Scene_transformation_table_time_keeper_app_callback, (void *)table,
+			TIME_KEEPER_APP_NEW_TIME);
+	}
+	display_message(INFORMATION_MESSAGE,
+		"Read %d transformations for %d regions from %s\n", number_of_samples,
+		static_cast<int>(table->tracks.size()), file_name);
+	return Scene_transformation_table_apply(table,
+		table->time_keeper_app->getTimeKeeper()->getTime());
+}
+
+int Scene_transformation_table_clear(struct Scene_transformation_table *table)
+{
+	if (!table)
+	{
+		display_message(ERROR_MESSAGE,
+			"Scene_transformation_table_clear.  Invalid argument(s)");
+		return 0;
+	}
+	if (!table->tracks.empty())
+	{
+		table->time_keeper_app->removeCallback(
+			Scene_transformation_table_time_keeper_app_callback, (void *)table);
+	}
+	table->clear();
+	return 1;
+}
+
+int Scene_transformation_table_apply(struct Scene_transformation_table *table,
+	double time)
+{
+	if (!table)
+	{
+		display_message(ERROR_MESSAGE,
+			"Scene_transformation_table_apply.  Invalid argument(s)");
+		return 0;
+	}
+	if (table->tracks.empty())
+		return 1;
+	struct timeval start_time, end_time;
+	cmgui_gettimeofday(&start_time, (struct timezone *)NULL);
+	cmzn_region_begin_hierarchical_change(table->root_region);
+	for (size_t i = 0; i < table->tracks.size(); ++i)
+	{
+		Scene_transformation_track &track = table->tracks[i];
+		if (track.times.empty())
+			continue;
+		int index = static_cast<int>(std::upper_bound(track.times.begin(),
+			track.times.end(), time) - track.times.begin()) - 1;
+		if (index < 0)
+			index = 0;
+		if (index != track.applied_index)
+		{
+			// Cmgui has always used OpenGL-style column major transformation matrices
+			track.scene->setTransformationMatrixColumnMajor(true);
+			cmzn_scene_set_transformation_matrix(track.scene, &track.matrices[16*index]);
+			track.applied_index = index;
+			++table->number_of_scene_changes;
+		}
+	}
+	cmzn_region_end_hierarchical_change(table->root_region);
+	cmgui_gettimeofday(&end_time, (struct timezone *)NULL);
+	const double update_time = cmgui_get_elapsed_seconds(&start_time, &end_time);
+	++table->number_of_updates;
+	table->update_time += update_time;
+	if (update_time > table->maximum_update_time)
+		table->maximum_update_time = update_time;
+	return 1;
+}
+
+int Scene_transformation_table_list(struct Scene_transformation_table *table)
+{
+	if (!table)
+	{
+		display_message(ERROR_MESSAGE,
+			"Scene_transformation_table_list.  Invalid argument(s)");
+		return 0;
+	}
+	if (table->tracks.empty())
+	{
+		display_message(INFORMATION_MESSAGE, "Transformation table is empty\n");
+		return 1;
+	}
+	size_t number_of_samples = 0;
+	double minimum_time = 0.0, maximum_time = 0.0;
+	bool first = true;
+	for (size_t i = 0; i < table->tracks.size(); ++i)
+	{
+		const std::vector<double> &times = table->tracks[i].times;
+		if (times.empty())
+			continue;
+		number_of_samples += times.size();
+		if (first || (times.front() < minimum_time))
+			minimum_time = times.front();
+		if (first || (times.back() > maximum_time))
+			maximum_time = times.back();
+		first = false;
+	}
+	display_message(INFORMATION_MESSAGE,
+		"Transformation table:  %d regions, %d transformations from time %g to %g\n",
+		static_cast<int>(table->tracks.size()), static_cast<int>(number_of_samples),
+		minimum_time, maximum_time);
+	if (0 < table->number_of_updates)
+	{
+		display_message(INFORMATION_MESSAGE,
+			"  Updates = %d, scene changes = %d, mean update time = %g s, maximum = %g s\n",
+			table->number_of_updates, table->number_of_scene_changes,
+			table->update_time/(double)table->number_of_updates, table->maximum_update_time);
+	}
+	return 1;
+}
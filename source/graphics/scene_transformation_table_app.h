@@ -0,0 +1,70 @@
+/**
+ * FILE : scene_transformation_table_app.h
+ *
+ * Tables of scene transformations over time, applied on time changes.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#if !defined (SCENE_TRANSFORMATION_TABLE_APP_H)
+#define SCENE_TRANSFORMATION_TABLE_APP_H
+
+#include "opencmiss/zinc/types/regionid.h"
+#include "general/object.h"
+
+struct Time_keeper_app;
+
+/**
+ * Transformation matrices for the scenes of any number of regions at a set of
+ * times each. Whenever the time keeper time changes, each scene is given the
+ * matrix at the latest of its times not after the new time, all within one
+ * hierarchical change of the root region. Tracks for regions removed from the
+ * tree are dropped.
+ */
+struct Scene_transformation_table;
+
+struct Scene_transformation_table *CREATE(Scene_transformation_table)(
+	cmzn_region_id root_region, struct Time_keeper_app *time_keeper_app);
+
+int DESTROY(Scene_transformation_table)(
+	struct Scene_transformation_table **table_address);
+
+/**
+ * Replaces the contents of table with those read from file_name, and applies
+ * them at the current time. Binary files start with the 8 characters
+ * "CMTRANS1" followed by, in native byte order, a 32-bit number of regions and
+ * for each region: 32-bit path length, path characters, 32-bit number of
+ * times, that many double times, then 16 doubles per time. Otherwise the file
+ * is read as text with one line per region and time:
+ *   REGION_PATH, TIME, 16 matrix values
+ * separated by commas or white space. Blank lines, lines starting with # and a
+ * first line with non-numeric time are ignored. Binary counts larger than
+ * the rest of the file can hold are rejected as invalid. Matrix values are in the same
+ * column major order as for gfx set transformation.
+ * @return  1 on success, 0 on failure with table unchanged.
+ */
+int Scene_transformation_table_read_file(
+	struct Scene_transformation_table *table, const char *file_name);
+
+/**
+ * Removes all transformations from table. Scenes keep their current
+ * transformations.
+ */
+int Scene_transformation_table_clear(struct Scene_transformation_table *table);
+
+/**
+ * Sets the transformation of each scene in table to its matrix at time.
+ * Scenes whose matrix is unchanged since they were last set are not touched.
+ */
+int Scene_transformation_table_apply(struct Scene_transformation_table *table,
+	double time);
+
+/**
+ * Lists the size of table and the number and cost of its updates.
+ */
+int Scene_transformation_table_list(struct Scene_transformation_table *table);
+
+#endif /* !defined (SCENE_TRANSFORMATION_TABLE_APP_H) */
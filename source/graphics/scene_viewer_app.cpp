@@ -160,6 +160,8 @@ struct Scene_viewer_app *CREATE(Scene_viewer_app)(struct Graphics_buffer_app *gr
 			cmzn_sceneviewer_set_scenefilter(scene_viewer->core_scene_viewer, filter);
 			scene_viewer->user_interface = user_interface;
 			scene_viewer->idle_update_callback_id = (struct Event_dispatcher_idle_callback *)NULL;
+			scene_viewer->redraw_request_function = 0;
+			scene_viewer->redraw_request_user_data = 0;
 			/* no current interactive_tool */
 			scene_viewer->interactive_tool=(struct Interactive_tool *)NULL;
 			/* Currently only set when created from a cmzn_sceneviewermodule
@@ -214,6 +216,8 @@ struct Scene_viewer_app *Scene_viewer_app_for_spectrum_create(struct Graphics_bu
 			cmzn_sceneviewer_set_scene(scene_viewer->core_scene_viewer, scene);
 			scene_viewer->user_interface = user_interface;
 			scene_viewer->idle_update_callback_id = (struct Event_dispatcher_idle_callback *)NULL;
+			scene_viewer->redraw_request_function = 0;
+			scene_viewer->redraw_request_user_data = 0;
 			/* no current interactive_tool */
 			scene_viewer->interactive_tool=(struct Interactive_tool *)NULL;
 			/* Currently only set when created from a cmzn_sceneviewermodule
@@ -978,35 +982,25 @@ extensions can get the updated frame from the backbuffer.
 	return (return_code);
 } /* Scene_viewer_redraw_now_without_swapbuffers */
 
-int Scene_viewer_app_idle_update_callback(void *scene_viewer_void)
-/*******************************************************************************
-LAST MODIFIED : 14 July 2000
-
-DESCRIPTION :
-Updates the scene_viewer.
-==============================================================================*/
+int Scene_viewer_app_update_now(struct Scene_viewer_app *scene_viewer)
 {
-	int repeat_idle;
-	struct Scene_viewer_app *scene_viewer=(struct Scene_viewer_app *)scene_viewer_void;
-
-	ENTER(Scene_viewer_app_idle_update_callback);
-	if (scene_viewer != 0)
+	int tumbling = 0;
+	if (scene_viewer)
 	{
-		/* set workproc no longer pending */
-		scene_viewer->idle_update_callback_id = (struct Event_dispatcher_idle_callback *)NULL;
+		/* this update replaces any of its own still pending */
+		if (scene_viewer->idle_update_callback_id)
+		{
+			Event_dispatcher_remove_idle_callback(
+				User_interface_get_event_dispatcher(scene_viewer->user_interface),
+				scene_viewer->idle_update_callback_id);
+			scene_viewer->idle_update_callback_id = (struct Event_dispatcher_idle_callback *)NULL;
+		}
 		if (scene_viewer->core_scene_viewer->tumble_active &&
 				(!Interactive_tool_is_Transform_tool(scene_viewer->interactive_tool) ||
 				Interactive_tool_transform_get_free_spin(scene_viewer->interactive_tool)))
 		{
 			Scene_viewer_automatic_tumble(scene_viewer);
-			/* Repost the idle callback */
-			if(!scene_viewer->idle_update_callback_id)
-			{
-				scene_viewer->idle_update_callback_id = Event_dispatcher_add_idle_callback(
-					User_interface_get_event_dispatcher(scene_viewer->user_interface),
-					Scene_viewer_app_idle_update_callback, (void *)scene_viewer,
-					EVENT_DISPATCHER_IDLE_UPDATE_SCENE_VIEWER_PRIORITY);
-			}
+			tumbling = 1;
 		}
 		else
 		{
@@ -1018,19 +1012,45 @@ Updates the scene_viewer.
 		{
 			Graphics_buffer_app_swap_buffers(scene_viewer->graphics_buffer);
 		}
-		/* We don't want the idle callback to repeat so we return 0 */
-		repeat_idle = 0;
+	}
+	else
+	{
+		display_message(ERROR_MESSAGE,
+			"Scene_viewer_app_update_now.  Missing scene_viewer");
+	}
+	return tumbling;
+}
+
+int Scene_viewer_app_idle_update_callback(void *scene_viewer_void)
+/*******************************************************************************
+LAST MODIFIED : 14 July 2000
+
+DESCRIPTION :
+Updates the scene_viewer.
+==============================================================================*/
+{
+	struct Scene_viewer_app *scene_viewer=(struct Scene_viewer_app *)scene_viewer_void;
+
+	ENTER(Scene_viewer_app_idle_update_callback);
+	if (scene_viewer != 0)
+	{
+		/* set workproc no longer pending */
+		scene_viewer->idle_update_callback_id = (struct Event_dispatcher_idle_callback *)NULL;
+		if (Scene_viewer_app_update_now(scene_viewer))
+		{
+			/* Repost the idle callback */
+			Scene_viewer_app_redraw_in_idle_time(scene_viewer);
+		}
 	}
 	else
 	{
 		display_message(ERROR_MESSAGE,
 			"Scene_viewer_app_idle_update_callback.  Missing scene_viewer");
-		/* We don't want the idle callback to repeat so we return 0 */
-		repeat_idle = 0;
 	}
 	LEAVE;
 
-	return (repeat_idle);
+	/* We don't want the idle callback to repeat so we return 0 */
+	return (0);
 } /* Scene_viewer_app_idle_update_callback */
 
 int Scene_viewer_app_redraw_in_idle_time(struct Scene_viewer_app *scene_viewer)
@@ -1043,6 +1063,8 @@ Does this by putting a WorkProc on the queue - if not already done for this
 Scene_viewer - which will force a redraw at the next idle moment. If the
 scene_viewer is changed again before it is updated, a new WorkProc will not be
 put in the queue, but the old one will update the window to the new state.
+If a redraw request function has been set, it is called instead so the owner
+can schedule this scene_viewer with its others.
 ==============================================================================*/
 {
 	int return_code;
@@ -1050,7 +1072,12 @@ put in the queue, but the old one will update the window to the new state.
 	ENTER(Scene_viewer_redraw_in_idle_time);
 	if (scene_viewer)
 	{
-		if (!scene_viewer->idle_update_callback_id)
+		if (scene_viewer->redraw_request_function)
+		{
+			(scene_viewer->redraw_request_function)(scene_viewer,
+				scene_viewer->redraw_request_user_data);
+		}
+		else if (!scene_viewer->idle_update_callback_id)
 		{
 			scene_viewer->idle_update_callback_id = Event_dispatcher_add_idle_callback(
 				User_interface_get_event_dispatcher(scene_viewer->user_interface),
@@ -1070,6 +1097,31 @@ put in the queue, but the old one will update the window to the new state.
 	return (return_code);
 } /* Scene_viewer_redraw_in_idle_time */
 
+int Scene_viewer_app_set_redraw_request_function(
+	struct Scene_viewer_app *scene_viewer,
+	Scene_viewer_app_redraw_request_function function, void *user_data)
+{
+	if (scene_viewer)
+	{
+		scene_viewer->redraw_request_function = function;
+		scene_viewer->redraw_request_user_data = function ? user_data : 0;
+		/* a pending update of its own is now handled by the new owner */
+		if (function && scene_viewer->idle_update_callback_id &&
+			!scene_viewer->core_scene_viewer->tumble_active)
+		{
+			Event_dispatcher_remove_idle_callback(
+				User_interface_get_event_dispatcher(scene_viewer->user_interface),
+				scene_viewer->idle_update_callback_id);
+			scene_viewer->idle_update_callback_id = (struct Event_dispatcher_idle_callback *)NULL;
+			(function)(scene_viewer, user_data);
+		}
+		return 1;
+	}
+	display_message(ERROR_MESSAGE,
+		"Scene_viewer_app_set_redraw_request_function.  Missing scene_viewer");
+	return 0;
+}
+
 int Scene_viewer_app_add_input_callback(struct Scene_viewer_app *scene_viewer,
 	CMZN_CALLBACK_FUNCTION(Scene_viewer_app_input_callback) *function,
 	void *user_data, int add_first)
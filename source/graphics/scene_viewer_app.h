@@ -44,6 +44,11 @@ The default data used to create cmzn_sceneviewers.
 		*destroy_callback_list;
 };
 
+/* Function called in place of posting a per-viewer idle update, so that the
+	owner of several scene_viewers can coalesce their redraws */
+typedef int (*Scene_viewer_app_redraw_request_function)(
+	struct Scene_viewer_app *scene_viewer, void *user_data);
+
 struct Scene_viewer_app
 {
 	int access_count;
@@ -52,6 +57,9 @@ struct Scene_viewer_app
 	struct User_interface *user_interface;
 	/* interaction */
 	struct Event_dispatcher_idle_callback *idle_update_callback_id;
+	/* if set, idle time redraws are requested through this function instead */
+	Scene_viewer_app_redraw_request_function redraw_request_function;
+	void *redraw_request_user_data;
 	/* Note: interactive_tool is NOT accessed by Scene_viewer; up to dialog
 		 owning it to clear it if it is destroyed. This is usually ensured by having
 		 a tool chooser in the parent dialog */
@@ -122,12 +130,31 @@ so should not be modified or deallocated.
 ==============================================================================*/
 int Scene_viewer_app_idle_update_callback(void *scene_viewer_void);
 
+int Scene_viewer_app_update_now(struct Scene_viewer_app *scene_viewer);
+/*******************************************************************************
+DESCRIPTION :
+Does the work of an idle update of <scene_viewer>: advances an automatic tumble
+if one is active and the interactive tool allows free spin, otherwise stops it,
+then renders and swaps buffers. Returns 1 if the tumble continues, in which case
+the caller should request another redraw in idle time.
+==============================================================================*/
+
 int Scene_viewer_app_redraw(struct Scene_viewer_app *scene_viewer);
 
 int Scene_viewer_app_redraw_now(struct Scene_viewer_app *scene_viewer);
 
 int Scene_viewer_app_redraw_in_idle_time(struct Scene_viewer_app *scene_viewer);
 
+int Scene_viewer_app_set_redraw_request_function(
+	struct Scene_viewer_app *scene_viewer,
+	Scene_viewer_app_redraw_request_function function, void *user_data);
+/*******************************************************************************
+DESCRIPTION :
+Routes idle time redraw requests for <scene_viewer> through <function> so that
+its owner can redraw it together with other scene_viewers in a single pass.
+Pass a NULL <function> to restore the scene_viewer's own idle update.
+==============================================================================*/
+
 int Scene_viewer_app_redraw_now_with_overrides(struct Scene_viewer_app *scene_viewer,
 	int antialias, int transparency_layers);
 
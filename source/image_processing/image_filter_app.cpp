@@ -0,0 +1,629 @@
+/**
+ * FILE : image_filter_app.cpp
+ *
+ * Settings and result cache shared by the image processing filter field
+ * commands.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "opencmiss/zinc/field.h"
+#include "opencmiss/zinc/fieldimage.h"
+#include "opencmiss/zinc/fieldmodule.h"
+#include "opencmiss/zinc/region.h"
+#include "opencmiss/zinc/spectrum.h"
+#include "configure/cmgui_configure.h"
+#include "computed_field/computed_field.h"
+#include "computed_field/computed_field_image.h"
+#include "computed_field/computed_field_private.hpp"
+#include "general/debug.h"
+#include "general/image_utilities.h"
+#include "general/message.h"
+#include "graphics/spectrum.h"
+#include "graphics/spectrum_component.h"
+#include "graphics/spectrum_component_app.h"
+#include "graphics/texture.h"
+#include "image_processing/image_filter_app.h"
+
+namespace {
+
+/* number of threads last requested; 0 if not set by this module */
+int image_filter_number_of_threads = 0;
+
+/* set once a field using an image filter has been evaluated by cmgui, after
+ * which ITK has read its number of threads */
+bool image_filter_evaluated = false;
+
+struct Image_filter_cache_entry
+{
+	int number_of_images;
+	unsigned long long size;
+	unsigned long last_use;
+};
+
+typedef std::map<Image_filter_cache_key, Image_filter_cache_entry> Image_filter_cache_entry_map;
+
+/* types of image filter fields whose result depends only on their command
+ * string and source fields */
+const char *image_filter_type_strings[] =
+{
+	"binary_dilate_filter",
+	"binary_erode_filter",
+	"binary_threshold_filter",
+	"canny_edge_detection_filter",
+	"connected_threshold_filter",
+	"curvature_anisotropic_diffusion_filter",
+	"derivative_filter",
+	"discrete_gaussian_filter",
+	"fast_marching_filter",
+	"gradient_magnitude_recursive_gaussian_filter",
+	"histogram_filter",
+	"image_resample",
+	"mean_filter",
+	"rescale_intensity_filter",
+	"sigmoid_filter",
+	"threshold_filter"
+};
+
+bool Image_filter_is_filter_type(const char *type_string)
+{
+	if (!type_string)
+		return false;
+	const int number_of_types =
+		static_cast<int>(sizeof(image_filter_type_strings)/sizeof(image_filter_type_strings[0]));
+	for (int i = 0; i < number_of_types; ++i)
+	{
+		if (0 == strcmp(type_string, image_filter_type_strings[i]))
+			return true;
+	}
+	return false;
+}
+
+/** @return  true if field or any field it depends on is an image filter */
+bool Image_filter_field_uses_filter(cmzn_field_id field)
+{
+	if (Image_filter_is_filter_type(Computed_field_get_type_string(field)))
+		return true;
+	const int number_of_source_fields = cmzn_field_get_number_of_source_fields(field);
+	bool uses_filter = false;
+	for (int i = 1; (i <= number_of_source_fields) && !uses_filter; ++i)
+	{
+		cmzn_field_id source_field = cmzn_field_get_source_field(field, i);
+		uses_filter = Image_filter_field_uses_filter(source_field);
+		cmzn_field_destroy(&source_field);
+	}
+	return uses_filter;
+}
+
+/** @return  true if any region in the tree from region has an image filter
+ * field, which graphics may have evaluated */
+bool Image_filter_region_tree_has_filter(cmzn_region_id region)
+{
+	bool has_filter = false;
+	cmzn_fieldmodule_id fieldmodule = cmzn_region_get_fieldmodule(region);
+	cmzn_fielditerator_id iter = cmzn_fieldmodule_create_fielditerator(fieldmodule);
+	cmzn_field_id field;
+	while ((!has_filter) && (0 != (field = cmzn_fielditerator_next(iter))))
+	{
+		has_filter = Image_filter_is_filter_type(Computed_field_get_type_string(field));
+		cmzn_field_destroy(&field);
+	}
+	cmzn_fielditerator_destroy(&iter);
+	cmzn_fieldmodule_destroy(&fieldmodule);
+	cmzn_region_id child_region = cmzn_region_get_first_child(region);
+	while (child_region && !has_filter)
+	{
+		has_filter = Image_filter_region_tree_has_filter(child_region);
+		cmzn_region_reaccess_next_sibling(&child_region);
+	}
+	cmzn_region_destroy(&child_region);
+	return has_filter;
+}
+
+int Image_filter_cache_key_add_spectrum_component(
+	struct cmzn_spectrumcomponent *component, void *key_void)
+{
+	Image_filter_cache_key *key = static_cast<Image_filter_cache_key *>(key_void);
+	char *component_string = cmzn_spectrumcomponent_string(component,
+		SPECTRUM_COMPONENT_STRING_COMPLETE);
+	if (!component_string)
+		return 0;
+	*key = Image_filter_cache_key_add_bytes(*key, component_string,
+		strlen(component_string) + 1);
+	DEALLOCATE(component_string);
+	return 1;
+}
+
+/* Cached images are kept in an uncompressed image format, one file per image
+ * in the texture, with an index file recording their size and use order.
+ * Use order is kept in memory and only written with the index when entries
+ * are added or removed, or the cache is cleared or closed. */
+struct Image_filter_cache
+{
+	std::string directory;
+	unsigned long long maximum_size;
+	unsigned long long total_size;
+	unsigned long use_count;
+	int hits, misses;
+	/* set when use order has changed since the index was written */
+	bool index_changed;
+	Image_filter_cache_entry_map entries;
+};
+
+/* NULL when the cache is disabled */
+Image_filter_cache *image_filter_cache = 0;
+
+std::string Image_filter_cache_get_index_file_name()
+{
+	return image_filter_cache->directory + "/image_filter_cache.txt";
+}
+
+std::string Image_filter_cache_get_image_file_name(Image_filter_cache_key key,
+	int image_number)
+{
+	char name[64];
+	sprintf(name, "/%016llx_%d.rgb", key, image_number + 1);
+	return image_filter_cache->directory + name;
+}
+
+int Image_filter_cache_write_index()
+{
+	FILE *index_file = fopen(Image_filter_cache_get_index_file_name().c_str(), "w");
+	if (!index_file)
+	{
+		display_message(ERROR_MESSAGE,
+			"Image filter cache.  Could not write index in directory %s",
+			image_filter_cache->directory.c_str());
+		return 0;
+	}
+	for (Image_filter_cache_entry_map::const_iterator iter = image_filter_cache->entries.begin();
+		iter != image_filter_cache->entries.end(); ++iter)
+	{
+		fprintf(index_file, "%016llx %d %llu %lu\n", iter->first,
+			iter->second.number_of_images, iter->second.size, iter->second.last_use);
+	}
+	fclose(index_file);
+	image_filter_cache->index_changed = false;
+	return 1;
+}
+
+/** Writes the index if use order has changed since it was last written, then
+ * deletes the cache */
+void Image_filter_cache_close()
+{
+	if (!image_filter_cache)
+		return;
+	if (image_filter_cache->index_changed)
+		Image_filter_cache_write_index();
+	delete image_filter_cache;
+	image_filter_cache = 0;
+}
+
+void Image_filter_cache_read_index()
+{
+	FILE *index_file = fopen(Image_filter_cache_get_index_file_name().c_str(), "r");
+	if (!index_file)
+		return;
+	Image_filter_cache_key key;
+	Image_filter_cache_entry entry;
+	while (4 == fscanf(index_file, "%llx %d %llu %lu", &key,
+		&entry.number_of_images, &entry.size, &entry.last_use))
+	{
+		if ((0 == key) || (entry.number_of_images < 1))
+			continue;
+		image_filter_cache->entries[key] = entry;
+		image_filter_cache->total_size += entry.size;
+		if (entry.last_use >= image_filter_cache->use_count)
+			image_filter_cache->use_count = entry.last_use + 1;
+	}
+	fclose(index_file);
+}
+
+void Image_filter_cache_remove_entry(Image_filter_cache_entry_map::iterator iter)
+{
+	for (int i = 0; i < iter->second.number_of_images; ++i)
+		remove(Image_filter_cache_get_image_file_name(iter->first, i).c_str());
+	image_filter_cache->total_size -= iter->second.size;
+	image_filter_cache->entries.erase(iter);
+}
+
+/** Removes least recently used entries other than keep_key until the cache
+ * is within its maximum size.
+ * @return  Number of entries removed. */
+int Image_filter_cache_evict(Image_filter_cache_key keep_key)
+{
+	int number_removed = 0;
+	while (image_filter_cache->total_size > image_filter_cache->maximum_size)
+	{
+		Image_filter_cache_entry_map::iterator oldest = image_filter_cache->entries.end();
+		for (Image_filter_cache_entry_map::iterator iter = image_filter_cache->entries.begin();
+			iter != image_filter_cache->entries.end(); ++iter)
+		{
+			if ((iter->first != keep_key) && ((oldest == image_filter_cache->entries.end()) ||
+				(iter->second.last_use < oldest->second.last_use)))
+			{
+				oldest = iter;
+			}
+		}
+		if (oldest == image_filter_cache->entries.end())
+			break;
+		Image_filter_cache_remove_entry(oldest);
+		++number_removed;
+	}
+	return number_removed;
+}
+
+}
+
+int Image_filter_set_number_of_threads(int number_of_threads,
+	cmzn_region_id root_region)
+{
+	if (number_of_threads < 1)
+	{
+		display_message(ERROR_MESSAGE,
+			"Image_filter_set_number_of_threads.  Invalid number of threads %d", number_of_threads);
+		return 0;
+	}
+	if (number_of_threads == image_filter_number_of_threads)
+		return 1;
+	if (image_filter_evaluated ||
+		(root_region && Image_filter_region_tree_has_filter(root_region)))
+	{
+		display_message(ERROR_MESSAGE,
+			"Image filter threads cannot be changed once image filters may have been "
+			"evaluated, as ITK only reads the number of threads once. Set it before "
+			"defining any image filter fields.");
+		return 0;
+	}
+	char value[20];
+	sprintf(value, "%d", number_of_threads);
+#if defined (WIN32_SYSTEM)
+	const int result = _putenv_s("ITK_GLOBAL_DEFAULT_NUMBER_OF_THREADS", value);
+#else /* defined (WIN32_SYSTEM) */
+	const int result = setenv("ITK_GLOBAL_DEFAULT_NUMBER_OF_THREADS", value, /*overwrite*/1);
+#endif /* defined (WIN32_SYSTEM) */
+	if (0 != result)
+	{
+		display_message(ERROR_MESSAGE,
+			"Image_filter_set_number_of_threads.  Could not set number of threads");
+		return 0;
+	}
+	image_filter_number_of_threads = number_of_threads;
+	return 1;
+}
+
+void Image_filter_record_field_evaluation(cmzn_field_id field)
+{
+	if (field && (!image_filter_evaluated) && Image_filter_field_uses_filter(field))
+		image_filter_evaluated = true;
+}
+
+int Image_filter_get_number_of_threads(void)
+{
+	if (image_filter_number_of_threads)
+		return image_filter_number_of_threads;
+	const char *value = getenv("ITK_GLOBAL_DEFAULT_NUMBER_OF_THREADS");
+	if (value)
+	{
+		const int number_of_threads = atoi(value);
+		if (0 < number_of_threads)
+			return number_of_threads;
+	}
+	return 0;
+}
+
+int Image_filter_cache_set_directory(const char *directory,
+	double maximum_megabytes)
+{
+	if (directory && (maximum_megabytes <= 0.0))
+	{
+		display_message(ERROR_MESSAGE,
+			"Image_filter_cache_set_directory.  Invalid maximum megabytes %g", maximum_megabytes);
+		return 0;
+	}
+	Image_filter_cache_close();
+	if (!directory)
+		return 1;
+	image_filter_cache = new Image_filter_cache();
+	image_filter_cache->directory = directory;
+	image_filter_cache->maximum_size =
+		static_cast<unsigned long long>(maximum_megabytes*1024.0*1024.0);
+	image_filter_cache->total_size = 0;
+	image_filter_cache->use_count = 1;
+	image_filter_cache->hits = 0;
+	image_filter_cache->misses = 0;
+	image_filter_cache->index_changed = false;
+	Image_filter_cache_read_index();
+	/* fail now rather than on first write if the directory is not writable */
+	if (!Image_filter_cache_write_index())
+	{
+		delete image_filter_cache;
+		image_filter_cache = 0;
+		return 0;
+	}
+	if (0 < Image_filter_cache_evict(/*keep_key*/0))
+		Image_filter_cache_write_index();
+	return 1;
+}
+
+int Image_filter_cache_is_enabled(void)
+{
+	return (0 != image_filter_cache);
+}
+
+int Image_filter_cache_clear(void)
+{
+	if (!image_filter_cache)
+		return 1;
+	while (!image_filter_cache->entries.empty())
+		Image_filter_cache_remove_entry(image_filter_cache->entries.begin());
+	image_filter_cache->hits = 0;
+	image_filter_cache->misses = 0;
+	return Image_filter_cache_write_index();
+}
+
+int Image_filter_cache_list(void)
+{
+	if (!image_filter_cache)
+	{
+		display_message(INFORMATION_MESSAGE, "Image filter cache: off\n");
+		return 1;
+	}
+	display_message(INFORMATION_MESSAGE,
+		"Image filter cache: directory %s\n"
+		"  %d entries, %.1f of maximum %.1f megabytes\n"
+		"  %d hits, %d misses this session\n",
+		image_filter_cache->directory.c_str(),
+		static_cast<int>(image_filter_cache->entries.size()),
+		static_cast<double>(image_filter_cache->total_size)/(1024.0*1024.0),
+		static_cast<double>(image_filter_cache->maximum_size)/(1024.0*1024.0),
+		image_filter_cache->hits, image_filter_cache->misses);
+	return 1;
+}
+
+int Image_filter_cache_get_usage(int *number_of_entries_address,
+	unsigned long long *number_of_bytes_address)
+{
+	if (!(number_of_entries_address && number_of_bytes_address))
+		return 0;
+	if (!image_filter_cache)
+	{
+		*number_of_entries_address = 0;
+		*number_of_bytes_address = 0;
+		return 0;
+	}
+	*number_of_entries_address = static_cast<int>(image_filter_cache->entries.size());
+	*number_of_bytes_address = image_filter_cache->total_size;
+	return 1;
+}
+
+Image_filter_cache_key Image_filter_cache_key_add_bytes(
+	Image_filter_cache_key key, const void *bytes, size_t size)
+{
+	/* 64-bit FNV-1a */
+	const unsigned char *byte = static_cast<const unsigned char *>(bytes);
+	for (size_t i = 0; i < size; ++i)
+	{
+		key ^= byte[i];
+		key *= 1099511628211ULL;
+	}
+	return key;
+}
+
+int Image_filter_cache_key_add_field(Image_filter_cache_key *key,
+	cmzn_field_id field)
+{
+	if (!(key && field))
+	{
+		display_message(ERROR_MESSAGE,
+			"Image_filter_cache_key_add_field.  Invalid argument(s)");
+		return 0;
+	}
+	int return_code = 1;
+	char *description = cmzn_field_get_name(field);
+	*key = Image_filter_cache_key_add_bytes(*key, description, strlen(description) + 1);
+	DEALLOCATE(description);
+	cmzn_field_image_id image_field = cmzn_field_cast_image(field);
+	if (image_field)
+	{
+		/* identified by its pixels; its domain field is only assigned pixel
+		 * locations, so is not part of the key */
+		struct Texture *texture = cmzn_field_image_get_texture(image_field);
+		struct Cmgui_image *cmgui_image = texture ? Texture_get_image(texture) : 0;
+		if (cmgui_image)
+		{
+			const int width = Cmgui_image_get_width(cmgui_image);
+			const int height = Cmgui_image_get_height(cmgui_image);
+			const int number_of_images = Cmgui_image_get_number_of_images(cmgui_image);
+			const size_t image_size = static_cast<size_t>(width)*height*
+				Cmgui_image_get_number_of_components(cmgui_image)*
+				Cmgui_image_get_number_of_bytes_per_component(cmgui_image);
+			std::vector<unsigned char> pixels(image_size);
+			for (int i = 0; (i < number_of_images) && return_code; ++i)
+			{
+				if ((0 < image_size) && Cmgui_image_get_raw_pixels(cmgui_image, i,
+					/*left*/0, /*bottom*/0, width, height, &pixels[0]))
+				{
+					*key = Image_filter_cache_key_add_bytes(*key, &pixels[0], image_size);
+				}
+				else
+				{
+					return_code = 0;
+				}
+			}
+			DESTROY(Cmgui_image)(&cmgui_image);
+		}
+		else
+		{
+			return_code = 0;
+		}
+		cmzn_field_image_destroy(&image_field);
+	}
+	else if (Image_filter_is_filter_type(Computed_field_get_type_string(field)))
+	{
+		description = field->core->get_command_string();
+		if (description)
+		{
+			*key = Image_filter_cache_key_add_bytes(*key, description, strlen(description) + 1);
+			DEALLOCATE(description);
+			const int number_of_source_fields = cmzn_field_get_number_of_source_fields(field);
+			for (int i = 1; (i <= number_of_source_fields) && return_code; ++i)
+			{
+				cmzn_field_id source_field = cmzn_field_get_source_field(field, i);
+				return_code = Image_filter_cache_key_add_field(key, source_field);
+				cmzn_field_destroy(&source_field);
+			}
+		}
+		else
+		{
+			return_code = 0;
+		}
+	}
+	else
+	{
+		/* values of other fields can change without their definition changing */
+		return_code = 0;
+	}
+	if (0 == *key)
+		*key = 1;
+	return return_code;
+}
+
+int Image_filter_cache_key_add_spectrum(Image_filter_cache_key *key,
+	cmzn_spectrum_id spectrum)
+{
+	if (!(key && spectrum))
+	{
+		display_message(ERROR_MESSAGE,
+			"Image_filter_cache_key_add_spectrum.  Invalid argument(s)");
+		return 0;
+	}
+	const bool material_overwrite = cmzn_spectrum_is_material_overwrite(spectrum);
+	*key = Image_filter_cache_key_add_bytes(*key, &material_overwrite, sizeof(material_overwrite));
+	int return_code = FOR_EACH_OBJECT_IN_LIST(cmzn_spectrumcomponent)(
+		Image_filter_cache_key_add_spectrum_component, static_cast<void *>(key),
+		spectrum->list_of_components);
+	if (0 == *key)
+		*key = 1;
+	return return_code;
+}
+
+int Image_filter_cache_read(Image_filter_cache_key key,
+	struct Texture *texture, const char *image_name)
+{
+	if (!(image_filter_cache && key && texture))
+		return 0;
+	Image_filter_cache_entry_map::iterator iter = image_filter_cache->entries.find(key);
+	int return_code = (iter != image_filter_cache->entries.end());
+	for (int i = 0; return_code && (i < iter->second.number_of_images); ++i)
+	{
+		struct Cmgui_image_information *cmgui_image_information =
+			CREATE(Cmgui_image_information)();
+		Cmgui_image_information_add_file_name(cmgui_image_information,
+			const_cast<char *>(Image_filter_cache_get_image_file_name(key, i).c_str()));
+		struct Cmgui_image *cmgui_image = Cmgui_image_read(cmgui_image_information);
+		DESTROY(Cmgui_image_information)(&cmgui_image_information);
+		if (!cmgui_image)
+		{
+			return_code = 0;
+		}
+		else
+		{
+			if (0 == i)
+			{
+				return_code = Texture_set_image(texture, cmgui_image,
+					image_name, /*file_number_pattern*/0, /*start*/0, /*stop*/0, /*increment*/0,
+					/*crop_left*/0, /*crop_bottom*/0, /*crop_width*/0, /*crop_height*/0);
+			}
+			else
+			{
+				return_code = Texture_add_image(texture, cmgui_image,
+					/*crop_left*/0, /*crop_bottom*/0, /*crop_width*/0, /*crop_height*/0);
+			}
+			DESTROY(Cmgui_image)(&cmgui_image);
+		}
+	}
+	if (return_code)
+	{
+		++(image_filter_cache->hits);
+		iter->second.last_use = (image_filter_cache->use_count)++;
+		image_filter_cache->index_changed = true;
+	}
+	else
+	{
+		++(image_filter_cache->misses);
+		if (iter != image_filter_cache->entries.end())
+		{
+			display_message(WARNING_MESSAGE,
+				"Image filter cache.  Could not read cached image; evaluating it again");
+			Image_filter_cache_remove_entry(iter);
+			Image_filter_cache_write_index();
+		}
+	}
+	return return_code;
+}
+
+int Image_filter_cache_write(Image_filter_cache_key key,
+	struct Texture *texture)
+{
+	if (!(image_filter_cache && key && texture))
+	{
+		display_message(ERROR_MESSAGE, "Image_filter_cache_write.  Invalid argument(s)");
+		return 0;
+	}
+	struct Cmgui_image *cmgui_image = Texture_get_image(texture);
+	if (!cmgui_image)
+	{
+		display_message(ERROR_MESSAGE,
+			"Image_filter_cache_write.  Could not get image from texture");
+		return 0;
+	}
+	Image_filter_cache_entry_map::iterator iter = image_filter_cache->entries.find(key);
+	if (iter != image_filter_cache->entries.end())
+		Image_filter_cache_remove_entry(iter);
+	Image_filter_cache_entry entry;
+	entry.number_of_images = Cmgui_image_get_number_of_images(cmgui_image);
+	const int number_of_bytes_per_component =
+		Cmgui_image_get_number_of_bytes_per_component(cmgui_image);
+	entry.size = static_cast<unsigned long long>(Cmgui_image_get_width(cmgui_image))*
+		Cmgui_image_get_height(cmgui_image)*entry.number_of_images*
+		Cmgui_image_get_number_of_components(cmgui_image)*number_of_bytes_per_component;
+	entry.last_use = (image_filter_cache->use_count)++;
+	struct Cmgui_image_information *cmgui_image_information =
+		CREATE(Cmgui_image_information)();
+	Cmgui_image_information_set_number_of_bytes_per_component(
+		cmgui_image_information, number_of_bytes_per_component);
+	for (int i = 0; i < entry.number_of_images; ++i)
+	{
+		Cmgui_image_information_add_file_name(cmgui_image_information,
+			const_cast<char *>(Image_filter_cache_get_image_file_name(key, i).c_str()));
+	}
+	int return_code = Cmgui_image_write(cmgui_image, cmgui_image_information);
+	DESTROY(Cmgui_image_information)(&cmgui_image_information);
+	DESTROY(Cmgui_image)(&cmgui_image);
+	if (return_code)
+	{
+		image_filter_cache->entries[key] = entry;
+		image_filter_cache->total_size += entry.size;
+		Image_filter_cache_evict(key);
+	}
+	else
+	{
+		display_message(WARNING_MESSAGE,
+			"Image filter cache.  Could not write image to directory %s",
+			image_filter_cache->directory.c_str());
+		for (int i = 0; i < entry.number_of_images; ++i)
+			remove(Image_filter_cache_get_image_file_name(key, i).c_str());
+	}
+	Image_filter_cache_write_index();
+	return return_code;
+}
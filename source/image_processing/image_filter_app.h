@@ -0,0 +1,134 @@
+/**
+ * FILE : image_filter_app.h
+ *
+ * Settings and result cache shared by the image processing filter field
+ * commands.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#if !defined (IMAGE_FILTER_APP_H)
+#define IMAGE_FILTER_APP_H
+
+#include <stddef.h>
+#include "opencmiss/zinc/types/fieldid.h"
+#include "opencmiss/zinc/types/regionid.h"
+#include "opencmiss/zinc/types/spectrumid.h"
+
+struct Texture;
+
+/**
+ * Sets the number of threads ITK image filters use, via the ITK global default
+ * which ITK reads once, when the first image filter is evaluated. Fails once
+ * a field using an image filter has been evaluated through
+ * Image_filter_record_field_evaluation, or while any image filter field
+ * exists under root_region, since graphics may have evaluated it.
+ *
+ * @param number_of_threads  Number of threads, at least 1.
+ * @param root_region  Optional root of regions to check for image filter
+ * fields.
+ * @return  1 on success, 0 on failure.
+ */
+int Image_filter_set_number_of_threads(int number_of_threads,
+	cmzn_region_id root_region);
+
+/**
+ * Records that field is about to be evaluated, so if it uses an image filter
+ * the number of threads can no longer be changed.
+ */
+void Image_filter_record_field_evaluation(cmzn_field_id field);
+
+/**
+ * Gets the number of threads ITK image filters are set to use, either by
+ * Image_filter_set_number_of_threads or from the environment.
+ *
+ * @return  Number of threads, or 0 if ITK chooses its own default.
+ */
+int Image_filter_get_number_of_threads(void);
+
+/** Hash identifying an image evaluated from a field; 0 is never a valid key */
+typedef unsigned long long Image_filter_cache_key;
+
+#define IMAGE_FILTER_CACHE_KEY_START 14695981039346656037ULL
+
+/**
+ * Enables the on-disk cache of images evaluated from image filter fields, or
+ * disables it if directory is NULL. Entries found in the directory from
+ * earlier sessions are reused. Least recently used entries are removed once
+ * the total size exceeds maximum_megabytes. Use order from cache hits is
+ * saved in the directory's index when the cache is disabled or changed.
+ *
+ * @param directory  Existing directory to store cached images in, or NULL.
+ * @return  1 on success, 0 on failure.
+ */
+int Image_filter_cache_set_directory(const char *directory,
+	double maximum_megabytes);
+
+/** @return  1 if the image filter cache is enabled, otherwise 0. */
+int Image_filter_cache_is_enabled(void);
+
+/**
+ * Removes all entries from the image filter cache and resets its counters.
+ * @return  1 on success, 0 on failure.
+ */
+int Image_filter_cache_clear(void);
+
+/**
+ * Lists the image filter cache directory, size, and hit and miss counts.
+ * @return  1 on success, 0 on failure.
+ */
+int Image_filter_cache_list(void);
+
+/**
+ * Gets the number of images in the image filter cache and the bytes they use
+ * on disk.
+ * @return  1 if the cache is enabled, otherwise 0 with outputs set to 0.
+ */
+int Image_filter_cache_get_usage(int *number_of_entries_address,
+	unsigned long long *number_of_bytes_address);
+
+/** @return  key updated with the given bytes. */
+Image_filter_cache_key Image_filter_cache_key_add_bytes(
+	Image_filter_cache_key key, const void *bytes, size_t size);
+
+/**
+ * Updates key with the definition of field and of all fields it depends on,
+ * including the pixels of any image fields among them. Only image fields and
+ * image filter fields can be described, since the values of other fields can
+ * change without their definition changing.
+ * @return  1 on success, 0 if field does not come from images only through
+ * image filters, so its result must not be cached.
+ */
+int Image_filter_cache_key_add_field(Image_filter_cache_key *key,
+	cmzn_field_id field);
+
+/**
+ * Updates key with the complete definition of spectrum, including all its
+ * components.
+ * @return  1 on success, 0 on failure.
+ */
+int Image_filter_cache_key_add_spectrum(Image_filter_cache_key *key,
+	cmzn_spectrum_id spectrum);
+
+/**
+ * Sets the image of texture from the cache entry for key, if there is one.
+ * Counts a hit or miss.
+ *
+ * @param image_name  Name given to the image in texture.
+ * @return  1 if texture was set from the cache, otherwise 0.
+ */
+int Image_filter_cache_read(Image_filter_cache_key key,
+	struct Texture *texture, const char *image_name);
+
+/**
+ * Stores the image of texture in the cache under key, evicting least
+ * recently used entries to keep within the size limit.
+ * @return  1 on success, 0 on failure.
+ */
+int Image_filter_cache_write(Image_filter_cache_key key,
+	struct Texture *texture);
+
+#endif /* !defined (IMAGE_FILTER_APP_H) */
@@ -4,12 +4,17 @@
 * License, v. 2.0. If a copy of the MPL was not distributed with this
 * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include <math.h>
+#include <vector>
 #include "opencmiss/zinc/field.h"
+#include "opencmiss/zinc/fieldcache.h"
 #include "opencmiss/zinc/fieldmodule.h"
 #include "opencmiss/zinc/fieldgroup.h"
 #include "opencmiss/zinc/optimisation.h"
 #include "opencmiss/zinc/region.h"
 #include "opencmiss/zinc/status.h"
+#include "opencmiss/zinc/timekeeper.h"
+#include "general/cmgui_time.h"
 #include "general/debug.h"
 #include "general/message.h"
 #include "command/parser.h"
@@ -17,18 +22,291 @@
 #include "general/enumerator_private.hpp"
 #include "region/cmiss_region_app.h"
 #include "minimise/minimise.h"
+#include "minimise/minimise_app.h"
+#include "user_interface/event_dispatcher.h"
+
+namespace {
+
+/**
+ * Evaluates the objective minimised by method: the sum of the squares of the
+ * components of the objective fields for LEAST_SQUARES_QUASI_NEWTON,
+ * otherwise the sum of their components.
+ * @return  1 on success, 0 if any objective field could not be evaluated.
+ */
+int Minimise_evaluate_objective(cmzn_fieldmodule_id fieldmodule,
+	const std::vector<cmzn_field_id> &objective_fields,
+	enum cmzn_optimisation_method method, double time, double *objective)
+{
+	int return_code = 1;
+	*objective = 0.0;
+	cmzn_fieldcache_id fieldcache = cmzn_fieldmodule_create_fieldcache(fieldmodule);
+	cmzn_fieldcache_set_time(fieldcache, time);
+	std::vector<double> values;
+	for (size_t i = 0; (i < objective_fields.size()) && return_code; ++i)
+	{
+		const int number_of_components = cmzn_field_get_number_of_components(objective_fields[i]);
+		values.resize(number_of_components);
+		if (CMZN_OK == cmzn_field_evaluate_real(objective_fields[i], fieldcache,
+			number_of_components, &values[0]))
+		{
+			for (int c = 0; c < number_of_components; ++c)
+			{
+				if (CMZN_OPTIMISATION_METHOD_LEAST_SQUARES_QUASI_NEWTON == method)
+					*objective += values[c]*values[c];
+				else
+					*objective += values[c];
+			}
+		}
+		else
+		{
+			return_code = 0;
+		}
+	}
+	cmzn_fieldcache_destroy(&fieldcache);
+	return return_code;
+}
+
+}
+
+/**
+ * An asynchronous minimise runs its optimisation for step_iterations at a
+ * time from an idle callback, so graphics show the updated parameters and the
+ * event loop, rendering and command window stay responsive between steps.
+ * Zinc is not thread safe, so it is not run on a separate thread. Zinc's
+ * optimisation keeps no state between calls to optimise, so each step
+ * restarts the method from the current parameters; quasi-Newton curvature
+ * information is rebuilt each step and results can differ from a synchronous
+ * minimise.
+ */
+struct Minimise_run
+{
+	cmzn_fieldmodule_id fieldmodule;
+	cmzn_optimisation_id optimisation;
+	enum cmzn_optimisation_method method;
+	std::vector<cmzn_field_id> objective_fields;
+	int step_iterations;
+	int show_report;
+	double start_time;
+
+	Minimise_run(cmzn_fieldmodule_id fieldmoduleIn, cmzn_optimisation_id optimisationIn,
+			enum cmzn_optimisation_method methodIn, int step_iterationsIn, int show_reportIn) :
+		fieldmodule(cmzn_fieldmodule_access(fieldmoduleIn)),
+		optimisation(cmzn_optimisation_access(optimisationIn)),
+		method(methodIn),
+		step_iterations(step_iterationsIn),
+		show_report(show_reportIn),
+		start_time(cmgui_get_wall_time_seconds())
+	{
+	}
+
+	~Minimise_run()
+	{
+		for (size_t i = 0; i < this->objective_fields.size(); ++i)
+			cmzn_field_destroy(&(this->objective_fields[i]));
+		cmzn_optimisation_destroy(&this->optimisation);
+		cmzn_fieldmodule_destroy(&this->fieldmodule);
+	}
+};
+
+struct Minimise_package
+{
+	cmzn_region_id root_region;
+	struct Event_dispatcher *event_dispatcher;
+	cmzn_timekeeper_id timekeeper;
+	struct Event_dispatcher_idle_callback *idle_callback_id;
+	Minimise_run *run;
+	struct Minimise_progress progress;
+};
+
+namespace {
+
+double Minimise_package_get_time(struct Minimise_package *package)
+{
+	return (package->timekeeper) ? cmzn_timekeeper_get_time(package->timekeeper) : 0.0;
+}
+
+/**
+ * Ends the asynchronous minimise of package, writing its solution report if
+ * requested. A cancelled minimise leaves the dependent fields with the
+ * parameters reached by its last completed step.
+ */
+void Minimise_package_end_run(struct Minimise_package *package, int cancelled)
+{
+	if (package->idle_callback_id)
+	{
+		Event_dispatcher_remove_idle_callback(package->event_dispatcher,
+			package->idle_callback_id);
+		package->idle_callback_id = 0;
+	}
+	if (package->run)
+	{
+		if (package->run->show_report && !cancelled)
+		{
+			char *report = cmzn_optimisation_get_solution_report(package->run->optimisation);
+			if (report)
+			{
+				display_message_string(INFORMATION_MESSAGE, report);
+				DEALLOCATE(report);
+			}
+		}
+		package->progress.running = 0;
+		package->progress.cancelled = cancelled;
+		package->progress.elapsed_time = cmgui_get_wall_time_seconds() - package->run->start_time;
+		delete package->run;
+		package->run = 0;
+		if (package->progress.objective_valid && package->progress.initial_objective_valid)
+		{
+			display_message(INFORMATION_MESSAGE,
+				"gfx minimise:  %s after %d iterations in %g seconds; objective %g, initially %g\n",
+				cancelled ? "Cancelled" : "Finished", package->progress.iterations,
+				package->progress.elapsed_time, package->progress.objective,
+				package->progress.initial_objective);
+		}
+		else
+		{
+			display_message(INFORMATION_MESSAGE,
+				"gfx minimise:  %s after %d iterations in %g seconds\n",
+				cancelled ? "Cancelled" : "Finished", package->progress.iterations,
+				package->progress.elapsed_time);
+		}
+	}
+}
+
+/**
+ * Idle callback performing the next step of the asynchronous minimise.
+ * Each step changes the dependent fields, which notifies graphics to update
+ * before the next step is run. Cancel takes effect between steps.
+ */
+int Minimise_package_step_idle_callback(void *package_void)
+{
+	struct Minimise_package *package = static_cast<struct Minimise_package *>(package_void);
+	if (!(package && package->run))
+		return 0;
+	/* set idle callback no longer pending */
+	package->idle_callback_id = 0;
+	Minimise_run *run = package->run;
+	struct Minimise_progress &progress = package->progress;
+	int step_iterations = progress.maximum_iterations - progress.iterations;
+	if (step_iterations > run->step_iterations)
+		step_iterations = run->step_iterations;
+	const double step_start_time = cmgui_get_wall_time_seconds();
+	int return_code = (CMZN_OK == cmzn_optimisation_set_attribute_integer(run->optimisation,
+		CMZN_OPTIMISATION_ATTRIBUTE_MAXIMUM_ITERATIONS, step_iterations));
+	if (return_code)
+		return_code = cmzn_optimisation_optimise(run->optimisation);
+	const double step_end_time = cmgui_get_wall_time_seconds();
+	progress.step_time = step_end_time - step_start_time;
+	progress.elapsed_time = step_end_time - run->start_time;
+	progress.iterations += step_iterations;
+	const double last_objective = progress.objective;
+	const int last_objective_valid = progress.objective_valid;
+	progress.objective_valid = Minimise_evaluate_objective(run->fieldmodule,
+		run->objective_fields, run->method, Minimise_package_get_time(package),
+		&progress.objective);
+	if (!return_code)
+	{
+		display_message(ERROR_MESSAGE, "gfx minimise.  Optimisation failed.");
+		Minimise_package_end_run(package, /*cancelled*/1);
+		return 0;
+	}
+	if (run->show_report)
+	{
+		if (progress.objective_valid)
+		{
+			display_message(INFORMATION_MESSAGE,
+				"gfx minimise:  iteration %d objective %g (%g seconds)\n",
+				progress.iterations, progress.objective, progress.step_time);
+		}
+		else
+		{
+			display_message(INFORMATION_MESSAGE,
+				"gfx minimise:  iteration %d (%g seconds)\n",
+				progress.iterations, progress.step_time);
+		}
+	}
+	/* each step restarts the optimisation from the current parameters, so an
+		 unchanged objective means no further progress will be made */
+	const int converged = progress.objective_valid && last_objective_valid &&
+		(fabs(progress.objective - last_objective) <= 1.0E-12*(1.0 + fabs(last_objective)));
+	if (converged || (progress.iterations >= progress.maximum_iterations))
+	{
+		Minimise_package_end_run(package, /*cancelled*/0);
+	}
+	else
+	{
+		package->idle_callback_id = Event_dispatcher_add_idle_callback(
+			package->event_dispatcher, Minimise_package_step_idle_callback,
+			package_void, EVENT_DISPATCHER_MINIMISE_PRIORITY);
+		if (!package->idle_callback_id)
+			Minimise_package_end_run(package, /*cancelled*/1);
+	}
+	/* We don't want the idle callback to repeat so we return 0 */
+	return 0;
+}
+
+}
+
+struct Minimise_package *CREATE(Minimise_package)(cmzn_region_id root_region,
+	struct Event_dispatcher *event_dispatcher, cmzn_timekeeper_id timekeeper)
+{
+	struct Minimise_package *package = 0;
+	if (root_region)
+	{
+		package = new Minimise_package();
+		package->root_region = cmzn_region_access(root_region);
+		package->event_dispatcher = event_dispatcher;
+		package->timekeeper = (timekeeper) ? cmzn_timekeeper_access(timekeeper) : 0;
+		package->idle_callback_id = 0;
+		package->run = 0;
+		package->progress.running = 0;
+		package->progress.cancelled = 0;
+		package->progress.iterations = 0;
+		package->progress.maximum_iterations = 0;
+		package->progress.initial_objective = 0.0;
+		package->progress.initial_objective_valid = 0;
+		package->progress.objective = 0.0;
+		package->progress.objective_valid = 0;
+		package->progress.step_time = 0.0;
+		package->progress.elapsed_time = 0.0;
+	}
+	else
+	{
+		display_message(ERROR_MESSAGE, "CREATE(Minimise_package).  Invalid argument(s)");
+	}
+	return (package);
+}
+
+int DESTROY(Minimise_package)(struct Minimise_package **package_address)
+{
+	if (package_address && (*package_address))
+	{
+		struct Minimise_package *package = *package_address;
+		Minimise_package_end_run(package, /*cancelled*/1);
+		if (package->timekeeper)
+			cmzn_timekeeper_destroy(&package->timekeeper);
+		cmzn_region_destroy(&package->root_region);
+		delete package;
+		*package_address = 0;
+		return 1;
+	}
+	return 0;
+}
 
 int gfx_minimise(struct Parse_state *state, void *dummy_to_be_modified,
-	void *root_region_void)
+	void *minimise_package_void)
 {
 	int return_code;
 	USE_PARAMETER(dummy_to_be_modified);
-	cmzn_region_id root_region = reinterpret_cast<cmzn_region_id>(root_region_void);
-	if (state && root_region)
+	struct Minimise_package *package = static_cast<struct Minimise_package *>(minimise_package_void);
+	if (state && package)
 	{
+		cmzn_region_id root_region = package->root_region;
 		enum cmzn_optimisation_method optimisation_method = CMZN_OPTIMISATION_METHOD_QUASI_NEWTON;
 		int maxIters = 100; // default value
+		int updateIters = 10;
 		int showReport = 1; // output solution report by default
+		char asynchronous = 0;
+		char cancel = 0;
 		const char *optimisation_method_string = 0;
 		Multiple_strings conditionalFieldNames;
 		Multiple_strings dependentFieldNames;
@@ -49,7 +327,18 @@ int gfx_minimise(struct Parse_state *state, void *dummy_to_be_modified,
 			"special behaviour with the LEAST_SQUARES_QUASI_NEWTON solution method, "
 			"supplying individual terms for the least squares solution, useful for "
 			"least squares fitting problems. NEWTON method only works with a finite "
-			"element dependent field and no conditional fields.");
+			"element dependent field and no conditional fields. With 'asynchronous' "
+			"the command returns at once and the optimisation runs "
+			"'update_iterations' at a time while the program remains interactive, "
+			"updating graphics between steps. Each step restarts the method from "
+			"the current parameters, so results can differ from a synchronous "
+			"minimise. Use 'gfx list minimise' to see its progress and "
+			"'gfx minimise cancel' to stop it after the current step, leaving the "
+			"parameters reached by that step.");
+		/* asynchronous */
+		Option_table_add_char_flag_entry(option_table, "asynchronous", &asynchronous);
+		/* cancel */
+		Option_table_add_char_flag_entry(option_table, "cancel", &cancel);
 		/* conditional_fields */
 		Option_table_add_multiple_strings_entry(option_table, "conditional_fields",
 			&conditionalFieldNames, "FIELD_NAME|none [& FIELD_NAME|none [& ...]]");
@@ -82,9 +371,35 @@ int gfx_minimise(struct Parse_state *state, void *dummy_to_be_modified,
 		Option_table_add_set_cmzn_region(option_table, "region", root_region, &region);
 		/* flag whether to show or hide the optimisation output */
 		Option_table_add_switch(option_table, "show_output", "hide_output", &showReport);
+		/* iterations per asynchronous step */
+		Option_table_add_entry(option_table, "update_iterations", &updateIters,
+			NULL, set_int_positive);
 		return_code = Option_table_multi_parse(option_table, state);
-		if (return_code)
+		if (return_code && cancel)
+		{
+			if (package->run)
+			{
+				Minimise_package_end_run(package, /*cancelled*/1);
+			}
+			else
+			{
+				display_message(WARNING_MESSAGE, "gfx minimise:  No asynchronous minimise is running");
+			}
+		}
+		else if (return_code && package->run)
+		{
+			display_message(ERROR_MESSAGE, "gfx minimise:  An asynchronous minimise is already running. "
+				"Wait for it to finish or use 'gfx minimise cancel'");
+			return_code = 0;
+		}
+		else if (return_code && asynchronous && !package->event_dispatcher)
+		{
+			display_message(ERROR_MESSAGE, "gfx minimise:  Asynchronous minimise is not available");
+			return_code = 0;
+		}
+		else if (return_code)
 		{
+			std::vector<cmzn_field_id> objectiveFields;
 			cmzn_fieldmodule_id fieldModule = cmzn_region_get_fieldmodule(region);
 			cmzn_optimisation_id optimisation = cmzn_fieldmodule_create_optimisation(fieldModule);
 			STRING_TO_ENUMERATOR(cmzn_optimisation_method)(
@@ -139,8 +454,12 @@ int gfx_minimise(struct Parse_state *state, void *dummy_to_be_modified,
 					display_message(ERROR_MESSAGE, "gfx minimise:  Invalid or unrecognised objective field '%s'",
 						objectiveFieldNames.strings[i]);
 					return_code = 0;
+					cmzn_field_destroy(&objectiveField);
+				}
+				else
+				{
+					objectiveFields.push_back(objectiveField);
 				}
-				cmzn_field_destroy(&objectiveField);
 			}
 			if (CMZN_OK != cmzn_optimisation_set_attribute_integer(optimisation,
 				CMZN_OPTIMISATION_ATTRIBUTE_MAXIMUM_ITERATIONS, maxIters))
@@ -148,7 +467,36 @@ int gfx_minimise(struct Parse_state *state, void *dummy_to_be_modified,
 				display_message(ERROR_MESSAGE, "gfx minimise:  Invalid maximum_iterations %d", maxIters);
 				return_code = 0;
 			}
-			if (return_code)
+			if (return_code && asynchronous)
+			{
+				package->run = new Minimise_run(fieldModule, optimisation,
+					optimisation_method, updateIters, showReport);
+				package->run->objective_fields.swap(objectiveFields);
+				struct Minimise_progress &progress = package->progress;
+				progress.running = 1;
+				progress.cancelled = 0;
+				progress.iterations = 0;
+				progress.maximum_iterations = maxIters;
+				progress.initial_objective_valid = Minimise_evaluate_objective(fieldModule,
+					package->run->objective_fields, optimisation_method,
+					Minimise_package_get_time(package), &progress.initial_objective);
+				progress.objective = progress.initial_objective;
+				progress.objective_valid = progress.initial_objective_valid;
+				progress.step_time = 0.0;
+				progress.elapsed_time = 0.0;
+				package->idle_callback_id = Event_dispatcher_add_idle_callback(
+					package->event_dispatcher, Minimise_package_step_idle_callback,
+					(void *)package, EVENT_DISPATCHER_MINIMISE_PRIORITY);
+				if (!package->idle_callback_id)
+				{
+					display_message(ERROR_MESSAGE, "gfx minimise:  Could not start asynchronous minimise");
+					delete package->run;
+					package->run = 0;
+					progress.running = 0;
+					return_code = 0;
+				}
+			}
+			else if (return_code)
 			{
 				return_code = cmzn_optimisation_optimise(optimisation);
 				if (showReport)
@@ -165,6 +513,8 @@ int gfx_minimise(struct Parse_state *state, void *dummy_to_be_modified,
 					display_message(ERROR_MESSAGE, "gfx minimise.  Optimisation failed.");
 				}
 			}
+			for (size_t i = 0; i < objectiveFields.size(); ++i)
+				cmzn_field_destroy(&(objectiveFields[i]));
 			cmzn_optimisation_destroy(&optimisation);
 			cmzn_fieldmodule_destroy(&fieldModule);
 		}
@@ -178,3 +528,46 @@ int gfx_minimise(struct Parse_state *state, void *dummy_to_be_modified,
 	}
 	return (return_code);
 }
+
+int gfx_list_minimise(struct Parse_state *state, void *dummy_to_be_modified,
+	void *minimise_package_void)
+{
+	int return_code = 0;
+	USE_PARAMETER(dummy_to_be_modified);
+	struct Minimise_package *package = static_cast<struct Minimise_package *>(minimise_package_void);
+	if (state && package)
+	{
+		Option_table *option_table = CREATE(Option_table)();
+		Option_table_add_help(option_table,
+			"List the state of the current or last asynchronous minimise.");
+		return_code = Option_table_multi_parse(option_table, state);
+		DESTROY(Option_table)(&option_table);
+		if (return_code)
+		{
+			const struct Minimise_progress &progress = package->progress;
+			if (0 == progress.maximum_iterations)
+			{
+				display_message(INFORMATION_MESSAGE, "No asynchronous minimise has been run\n");
+			}
+			else
+			{
+				display_message(INFORMATION_MESSAGE, "Asynchronous minimise %s:\n",
+					progress.running ? "running" : (progress.cancelled ? "cancelled" : "finished"));
+				display_message(INFORMATION_MESSAGE, "  iterations %d of maximum %d\n",
+					progress.iterations, progress.maximum_iterations);
+				if (progress.initial_objective_valid)
+					display_message(INFORMATION_MESSAGE, "  initial objective %g\n", progress.initial_objective);
+				if (progress.objective_valid)
+					display_message(INFORMATION_MESSAGE, "  objective %g\n", progress.objective);
+				display_message(INFORMATION_MESSAGE,
+					"  last step %g seconds, elapsed %g seconds\n",
+					progress.step_time, progress.elapsed_time);
+			}
+		}
+	}
+	else
+	{
+		display_message(ERROR_MESSAGE, "gfx_list_minimise.  Invalid argument(s)");
+	}
+	return (return_code);
+}
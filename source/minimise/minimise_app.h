@@ -4,10 +4,67 @@
 * License, v. 2.0. If a copy of the MPL was not distributed with this
 * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#if !defined (MINIMISE_APP_H)
+#define MINIMISE_APP_H
+
+#include "opencmiss/zinc/types/regionid.h"
+#include "opencmiss/zinc/types/timekeeperid.h"
+#include "general/object.h"
+
+struct Event_dispatcher;
+
+/**
+ * State of the current or last asynchronous minimise.
+ */
+struct Minimise_progress
+{
+	/* 1 until the minimise finishes or is cancelled */
+	int running;
+	int cancelled;
+	/* iterations run so far and the maximum for the whole minimise */
+	int iterations;
+	int maximum_iterations;
+	/* objective minimised by the method before the minimise and after the
+	 * last step; only valid if the corresponding _valid flag is set */
+	double initial_objective;
+	int initial_objective_valid;
+	double objective;
+	int objective_valid;
+	/* seconds taken by the last step and since starting the minimise */
+	double step_time;
+	double elapsed_time;
+};
+
+/**
+ * Object owning the asynchronous minimise, if any, run for gfx minimise
+ * commands.
+ */
+struct Minimise_package;
+
+/**
+ * @param event_dispatcher  Dispatcher running asynchronous minimises
+ * when idle. If NULL, only synchronous minimise is available.
+ * @param timekeeper  Time keeper giving the time objectives are reported at.
+ */
+struct Minimise_package *CREATE(Minimise_package)(cmzn_region_id root_region,
+	struct Event_dispatcher *event_dispatcher, cmzn_timekeeper_id timekeeper);
+
+/**
+ * Cancels any asynchronous minimise and destroys the package.
+ */
+int DESTROY(Minimise_package)(struct Minimise_package **package_address);
+
 /***************************************************************************//**
  * Command modifier functions for setting parameters for an optimisation and
  * minimising the chosen objective fields by changing the dependent fields.
  */
 int gfx_minimise(struct Parse_state *state, void *dummy_to_be_modified,
-	void *root_region_void);
+	void *minimise_package_void);
+
+/**
+ * Lists the progress of the current or last asynchronous minimise.
+ */
+int gfx_list_minimise(struct Parse_state *state, void *dummy_to_be_modified,
+	void *minimise_package_void);
 
+#endif /* !defined (MINIMISE_APP_H) */
@@ -4,6 +4,11 @@
 * License, v. 2.0. If a copy of the MPL was not distributed with this
 * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include <list>
+#include <map>
+#include <string>
+#include "opencmiss/zinc/fieldgroup.h"
+#include "opencmiss/zinc/fieldmodule.h"
 #include "opencmiss/zinc/region.h"
 #include "opencmiss/zinc/streamregion.h"
 #include "general/message.h"
@@ -15,6 +20,288 @@
 #include "region/cmiss_region_app.h"
 #include "stream/region_stream.hpp"
 
+/**
+ * Cache of regions and group names found from paths relative to one root
+ * region. Regions on cached paths are accessed while watched for changes;
+ * groups are not held, but found by name when an entry is used, so they can
+ * still be destroyed. Changes to the children or name of any region on a
+ * cached path, or fields in them being removed or renamed, mark the cache
+ * invalid; it is cleared at the next lookup rather than from within the
+ * change callback.
+ */
+struct Region_path_cache
+{
+private:
+	struct Entry
+	{
+		/* not accessed: kept alive by watched_regions */
+		cmzn_region_id region;
+		/* empty if the path has no group */
+		std::string group_name;
+	};
+
+	cmzn_region_id root_region;
+	std::map<std::string, Entry> entries;
+	std::map<cmzn_region_id, cmzn_fieldmodulenotifier_id> watched_regions;
+	bool enabled;
+	bool invalid;
+	int hits;
+	int misses;
+	int invalidations;
+
+	/* caches in existence, found by root region for lookups from parsers */
+	static std::list<Region_path_cache *> caches;
+
+	static void regionChange(struct cmzn_region *region,
+		cmzn_region_changes *region_changes, void *cache_void)
+	{
+		USE_PARAMETER(region);
+		USE_PARAMETER(region_changes);
+		static_cast<Region_path_cache *>(cache_void)->invalid = true;
+	}
+
+	static void fieldmoduleChange(cmzn_fieldmoduleevent_id event, void *cache_void)
+	{
+		/* adding or redefining fields cannot change path resolution as regions
+			 take precedence over groups, which are found by name on each hit */
+		if (cmzn_fieldmoduleevent_get_summary_field_change_flags(event) &
+			(CMZN_FIELD_CHANGE_FLAG_REMOVE | CMZN_FIELD_CHANGE_FLAG_IDENTIFIER))
+		{
+			static_cast<Region_path_cache *>(cache_void)->invalid = true;
+		}
+	}
+
+	void watch(cmzn_region_id region)
+	{
+		if (this->watched_regions.find(region) != this->watched_regions.end())
+			return;
+		cmzn_region_access(region);
+		cmzn_region_add_callback(region, Region_path_cache::regionChange, (void *)this);
+		cmzn_fieldmodule_id fieldmodule = cmzn_region_get_fieldmodule(region);
+		cmzn_fieldmodulenotifier_id notifier = cmzn_fieldmodule_create_fieldmodulenotifier(fieldmodule);
+		cmzn_fieldmodulenotifier_set_callback(notifier, Region_path_cache::fieldmoduleChange, (void *)this);
+		cmzn_fieldmodule_destroy(&fieldmodule);
+		this->watched_regions[region] = notifier;
+	}
+
+	/** Clears the cache if invalid, and checks it is enabled */
+	bool prepare()
+	{
+		if (!this->enabled)
+			return false;
+		if (this->invalid)
+		{
+			this->clear();
+			++this->invalidations;
+		}
+		return true;
+	}
+
+public:
+
+	Region_path_cache(cmzn_region_id root_regionIn) :
+		root_region(cmzn_region_access(root_regionIn)),
+		enabled(true),
+		invalid(false),
+		hits(0),
+		misses(0),
+		invalidations(0)
+	{
+		caches.push_back(this);
+	}
+
+	~Region_path_cache()
+	{
+		caches.remove(this);
+		this->clear();
+		cmzn_region_destroy(&this->root_region);
+	}
+
+	/** @return  Cache for lookups from root_region, or NULL if none */
+	static Region_path_cache *findForRoot(cmzn_region_id root_region)
+	{
+		for (std::list<Region_path_cache *>::iterator iter = caches.begin();
+			iter != caches.end(); ++iter)
+		{
+			if ((*iter)->root_region == root_region)
+				return *iter;
+		}
+		return 0;
+	}
+
+	void clear()
+	{
+		this->entries.clear();
+		for (std::map<cmzn_region_id, cmzn_fieldmodulenotifier_id>::iterator iter =
+			this->watched_regions.begin(); iter != this->watched_regions.end(); ++iter)
+		{
+			cmzn_fieldmodulenotifier_clear_callback(iter->second);
+			cmzn_fieldmodulenotifier_destroy(&iter->second);
+			cmzn_region_remove_callback(iter->first, Region_path_cache::regionChange, (void *)this);
+			cmzn_region_id region = iter->first;
+			cmzn_region_destroy(&region);
+		}
+		this->watched_regions.clear();
+		this->invalid = false;
+	}
+
+	void setEnabled(bool enabledIn)
+	{
+		if (!enabledIn)
+			this->clear();
+		this->enabled = enabledIn;
+	}
+
+	/**
+	 * @param key  Path prefixed by a character identifying the type of lookup.
+	 * @return  true if found with accessed region and group returned. A
+	 * cached group no longer in the region is a miss.
+	 */
+	bool find(const std::string &key,
+		cmzn_region_id *region_address, cmzn_field_group_id *group_address)
+	{
+		if (!this->prepare())
+			return false;
+		std::map<std::string, Entry>::iterator iter = this->entries.find(key);
+		cmzn_field_group_id group = 0;
+		if ((iter != this->entries.end()) && (!iter->second.group_name.empty()))
+		{
+			cmzn_field *field = FIND_BY_IDENTIFIER_IN_MANAGER(Computed_field,name)(
+				iter->second.group_name.c_str(),
+				cmzn_region_get_Computed_field_manager(iter->second.region));
+			group = cmzn_field_cast_group(field);
+			if (!group)
+			{
+				this->entries.erase(iter);
+				iter = this->entries.end();
+			}
+		}
+		if (iter == this->entries.end())
+		{
+			++this->misses;
+			return false;
+		}
+		++this->hits;
+		*region_address = cmzn_region_access(iter->second.region);
+		*group_address = group;
+		return true;
+	}
+
+	/**
+	 * @param group_name  Name of group in region, or NULL if none.
+	 */
+	void add(const std::string &key, cmzn_region_id region, const char *group_name)
+	{
+		if (!this->prepare())
+			return;
+		if (this->entries.find(key) != this->entries.end())
+			return;
+		Entry entry;
+		entry.region = region;
+		if (group_name)
+			entry.group_name = group_name;
+		this->entries[key] = entry;
+		cmzn_region_id watch_region = cmzn_region_access(region);
+		while (watch_region)
+		{
+			this->watch(watch_region);
+			cmzn_region_id parent = (watch_region != this->root_region) ?
+				cmzn_region_get_parent(watch_region) : 0;
+			cmzn_region_destroy(&watch_region);
+			watch_region = parent;
+		}
+	}
+
+	void list()
+	{
+		display_message(INFORMATION_MESSAGE, "Region path cache:  %s\n",
+			this->enabled ? "on" : "off");
+		display_message(INFORMATION_MESSAGE,
+			"  Paths = %d, watched regions = %d\n",
+			static_cast<int>(this->entries.size()), static_cast<int>(this->watched_regions.size()));
+		const int lookups = this->hits + this->misses;
+		display_message(INFORMATION_MESSAGE,
+			"  Hits = %d, misses = %d (%.1f%% hits), invalidations = %d\n",
+			this->hits, this->misses,
+			(lookups > 0) ? 100.0*(double)this->hits/(double)lookups : 0.0,
+			this->invalidations);
+	}
+};
+
+std::list<Region_path_cache *> Region_path_cache::caches;
+
+namespace {
+
+/**
+ * Finds region at path from root_region through its region path cache, if
+ * any.
+ * @return  Accessed region or NULL if not found.
+ */
+cmzn_region_id Region_path_cache_find_subregion_at_path(cmzn_region_id root_region,
+	const char *path)
+{
+	Region_path_cache *cache = Region_path_cache::findForRoot(root_region);
+	const std::string key = std::string("r") + path;
+	cmzn_region_id region = 0;
+	cmzn_field_group_id group = 0;
+	if (cache && cache->find(key, &region, &group))
+		return region;
+	region = cmzn_region_find_subregion_at_path(root_region, path);
+	if (region && cache)
+		cache->add(key, region, static_cast<const char *>(0));
+	return region;
+}
+
+}
+
+struct Region_path_cache *CREATE(Region_path_cache)(cmzn_region_id root_region)
+{
+	if (!root_region)
+	{
+		display_message(ERROR_MESSAGE,
+			"CREATE(Region_path_cache).  Invalid argument(s)");
+		return 0;
+	}
+	return new Region_path_cache(root_region);
+}
+
+int DESTROY(Region_path_cache)(struct Region_path_cache **cache_address)
+{
+	if (!(cache_address && (*cache_address)))
+	{
+		display_message(ERROR_MESSAGE,
+			"DESTROY(Region_path_cache).  Invalid argument(s)");
+		return 0;
+	}
+	delete *cache_address;
+	*cache_address = 0;
+	return 1;
+}
+
+int Region_path_cache_set_enabled(struct Region_path_cache *cache, int enabled)
+{
+	if (!cache)
+		return 0;
+	cache->setEnabled(0 != enabled);
+	return 1;
+}
+
+int Region_path_cache_clear(struct Region_path_cache *cache)
+{
+	if (!cache)
+		return 0;
+	cache->clear();
+	return 1;
+}
+
+int Region_path_cache_list(struct Region_path_cache *cache)
+{
+	if (!cache)
+		return 0;
+	cache->list();
+	return 1;
+}
+
 int set_cmzn_region(struct Parse_state *state, void *region_address_void,
 	void *root_region_void)
 {
@@ -30,7 +317,7 @@ int set_cmzn_region(struct Parse_state *state, void *region_address_void,
 		{
 			if (!Parse_state_help_mode(state))
 			{
-				region = cmzn_region_find_subregion_at_path(root_region, current_token);
+				region = Region_path_cache_find_subregion_at_path(root_region, current_token);
 				if (region)
 				{
 					cmzn_region_destroy(region_address);
@@ -119,7 +406,7 @@ Modifier function for entering a path to a cmzn_region, starting at
 		{
 			if (!Parse_state_help_mode(state))
 			{
-				region = cmzn_region_find_subregion_at_path(
+				region = Region_path_cache_find_subregion_at_path(
 					root_region, current_token);
 				if (region)
 				{
@@ -316,6 +603,18 @@ int cmzn_region_path_to_subregion_and_group(cmzn_region_id root_region,
 	int return_code = CMZN_OK;
 	if (root_region && path && path[0] && region_address && group_address)
 	{
+		Region_path_cache *cache = Region_path_cache::findForRoot(root_region);
+		const std::string key = std::string("g") + path;
+		cmzn_region_id cached_region = 0;
+		cmzn_field_group_id cached_group = 0;
+		if (cache && cache->find(key, &cached_region, &cached_group))
+		{
+			cmzn_region_destroy(region_address);
+			*region_address = cached_region;
+			cmzn_field_group_destroy(group_address);
+			*group_address = cached_group;
+			return CMZN_OK;
+		}
 		char *region_path = 0;
 		char *field_name = 0;
 		cmzn_region_id output_region = 0;
@@ -337,6 +636,8 @@ int cmzn_region_path_to_subregion_and_group(cmzn_region_id root_region,
 					return_code = CMZN_ERROR_NOT_FOUND;
 			}
 			cmzn_field_group_destroy(&old_group);
+			if ((CMZN_OK == return_code) && cache)
+				cache->add(key, *region_address, field_name);
 		}
 		else
 			return_code = CMZN_ERROR_NOT_FOUND;
@@ -5,6 +5,7 @@
 * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 #include "opencmiss/zinc/region.h"
 #include "command/parser.h"
+#include "general/object.h"
 #include "finite_element/export_finite_element.h"
 
 /***************************************************************************//**
@@ -93,6 +94,42 @@ int cmzn_region_path_to_subregion_and_group(cmzn_region_id root_region,
 	const char *path, cmzn_region_id *region_address,
 	cmzn_field_group_id *group_address);
 
+/**
+ * Cache of regions and groups found from paths relative to a root region by
+ * set_cmzn_region, set_cmzn_region_path and
+ * cmzn_region_path_to_subregion_and_group. Lookups from a root region use the
+ * cache created for it, if any. The cache is cleared whenever the children or
+ * names of regions on cached paths change, or fields in them are removed or
+ * renamed. Groups are cached by name, so are not kept from being destroyed.
+ */
+struct Region_path_cache;
+
+/**
+ * Creates an enabled region path cache for lookups from root_region.
+ */
+struct Region_path_cache *CREATE(Region_path_cache)(cmzn_region_id root_region);
+
+/**
+ * Destroys the cache, releasing its handles on regions. Must be called before
+ * the region tree is destroyed.
+ */
+int DESTROY(Region_path_cache)(struct Region_path_cache **cache_address);
+
+/**
+ * Enables or disables the cache. Disabling clears it.
+ */
+int Region_path_cache_set_enabled(struct Region_path_cache *cache, int enabled);
+
+/**
+ * Clears the region path cache, releasing its handles on regions.
+ */
+int Region_path_cache_clear(struct Region_path_cache *cache);
+
+/**
+ * Lists the number of cached paths and lookup hits, misses and invalidations.
+ */
+int Region_path_cache_list(struct Region_path_cache *cache);
+
 int set_cmzn_region_or_group(struct Parse_state *state,
 	void *region_address_void, void *group_address_void);
 
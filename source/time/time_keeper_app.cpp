@@ -65,6 +65,11 @@ Time_keeper_app::Time_keeper_app(cmzn_timekeeper *time_keeper_in,
 	event_dispatcher(event_dispatcher),
 	callback_list(0),
 	time_keeper(cmzn_timekeeper_access(time_keeper_in)),
+	playback_frames(0),
+	playback_repeated_frames(0),
+	playback_notify_time(0.0),
+	playback_maximum_notify_time(0.0),
+	playback_start_time(0.0),
 	access_count(1)
 {
 }
@@ -107,6 +112,7 @@ int Time_keeper_app::play(enum cmzn_timekeeper_play_direction play_direction_in)
 	if(!isPlaying())
 	{
 		play_direction = play_direction_in;
+		resetPlaybackStatistics();
 		/*notify clients before playing. If play fails, notify of stop*/
 		notifyClients(TIME_KEEPER_APP_STARTED);
 		if(playPrivate())
@@ -374,6 +380,11 @@ cmzn_timekeeper *Time_keeper_app::getTimeKeeper()
 	return time_keeper;
 }
 
+double Time_keeper_app::getTimeStep()
+{
+	return step;
+}
+
 void Time_keeper_app::setTimeStep(double time_step)
 {
 	step = time_step;
@@ -393,6 +404,7 @@ int Time_keeper_app::timerEvent()
 		first_event_time = 1;
 
 		cmgui_gettimeofday(&timeofday, (struct timezone *)NULL);
+		struct timeval tick_start_time = timeofday;
 		real_time_elapsed = (double)(timeofday.tv_sec -
 			play_start_seconds) + ((double)(timeofday.tv_usec - play_start_microseconds) / 1000000.0);
 		real_time_elapsed *= speed;
@@ -545,6 +557,10 @@ int Time_keeper_app::timerEvent()
 			if(!first_event_time)
 			{
 				notifyClients(TIME_KEEPER_APP_NEW_TIME);
+				struct timeval tick_end_time;
+				cmgui_gettimeofday(&tick_end_time, (struct timezone *)NULL);
+				recordPlaybackFrame(event_time,
+					cmgui_get_elapsed_seconds(&tick_start_time, &tick_end_time));
 			}
 			setPlayTimeout();
 		}
@@ -564,6 +580,62 @@ int Time_keeper_app::timerEvent()
 	return (return_code);
 }
 
+void Time_keeper_app::recordPlaybackFrame(double frame_time, double notify_time)
+{
+	/* limit memory used to remember times shown */
+	const size_t maximum_playback_times = 100000;
+	++playback_frames;
+	if (playback_times.find(frame_time) != playback_times.end())
+	{
+		++playback_repeated_frames;
+	}
+	else if (playback_times.size() < maximum_playback_times)
+	{
+		playback_times.insert(frame_time);
+	}
+	playback_notify_time += notify_time;
+	if (notify_time > playback_maximum_notify_time)
+	{
+		playback_maximum_notify_time = notify_time;
+	}
+}
+
+void Time_keeper_app::resetPlaybackStatistics()
+{
+	playback_frames = 0;
+	playback_repeated_frames = 0;
+	playback_notify_time = 0.0;
+	playback_maximum_notify_time = 0.0;
+	playback_start_time = cmgui_get_wall_time_seconds();
+	playback_times.clear();
+}
+
+void Time_keeper_app::listPlaybackStatistics()
+{
+	display_message(INFORMATION_MESSAGE, "Timekeeper playback:  %s\n",
+		isPlaying() ? "playing" : "stopped");
+	if (0 == playback_frames)
+	{
+		display_message(INFORMATION_MESSAGE, "  No time steps played\n");
+		return;
+	}
+	const double elapsed_time = cmgui_get_wall_time_seconds() - playback_start_time;
+	display_message(INFORMATION_MESSAGE,
+		"  Time steps shown = %d, of which repeated = %d (%.1f%%)\n",
+		playback_frames, playback_repeated_frames,
+		100.0*(double)playback_repeated_frames/(double)playback_frames);
+	display_message(INFORMATION_MESSAGE,
+		"  Notify time: total = %g s, mean = %g s, maximum = %g s\n",
+		playback_notify_time, playback_notify_time/(double)playback_frames,
+		playback_maximum_notify_time);
+	if (elapsed_time > 0.0)
+	{
+		display_message(INFORMATION_MESSAGE,
+			"  Time steps per second = %g over %g s\n",
+			(double)playback_frames/elapsed_time, elapsed_time);
+	}
+}
+
 void Time_keeper_app::setPlayLoop()
 {
 	play_mode = TIME_KEEPER_APP_PLAY_LOOP;
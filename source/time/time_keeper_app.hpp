@@ -14,6 +14,7 @@
 
 #include "time/time_keeper.hpp"
 #include <ctime>
+#include <set>
 
 PROTOTYPE_OBJECT_FUNCTIONS(Time_keeper_app);
 
@@ -59,9 +60,18 @@ private:
 	struct Event_dispatcher *event_dispatcher;
 	struct Time_keeper_app_callback_data *callback_list;
 	cmzn_timekeeper *time_keeper;
+	/* playback statistics since play was last started */
+	int playback_frames;
+	int playback_repeated_frames;
+	double playback_notify_time;
+	double playback_maximum_notify_time;
+	double playback_start_time;
+	std::set<double> playback_times;
 
 	int notifyClients(enum Time_keeper_app_event event_mask);
 
+	void recordPlaybackFrame(double frame_time, double notify_time);
+
 public:
 
 	int access_count;
@@ -113,6 +123,8 @@ public:
 
 	void setPlaySwing();
 
+	double getTimeStep();
+
 	void setTimeStep(double time_step);
 
 	int setMaximum(double maximum_in);
@@ -126,6 +138,18 @@ public:
 	void setPlaySkipFrames();
 
 	int setPlayTimeout();
+
+	void resetPlaybackStatistics();
+
+	/**
+	 * Lists playback statistics since play was last started: number of time
+	 * steps shown, how many were times already shown earlier in the playback,
+	 * and the notify time taken to set each new time and call the time keeper
+	 * clients. Graphics are rebuilt and rendered later in idle redraws, so are
+	 * not part of the notify time; their cost shows in the time steps per
+	 * second achieved.
+	 */
+	void listPlaybackStatistics();
 };
 
 #endif
@@ -118,7 +118,8 @@ DESCRIPTION :
 	EVENT_DISPATCHER_TRACKING_EDITOR_PRIORITY,
 	EVENT_DISPATCHER_IDLE_UPDATE_SCENE_VIEWER_PRIORITY,
 	EVENT_DISPATCHER_SYNC_SCENE_VIEWERS_PRIORITY,
-	EVENT_DISPATCHER_TUMBLE_SCENE_VIEWER_PRIORITY
+	EVENT_DISPATCHER_TUMBLE_SCENE_VIEWER_PRIORITY,
+	EVENT_DISPATCHER_MINIMISE_PRIORITY
 };
 
 typedef int Event_dispatcher_timeout_function(void *user_data);